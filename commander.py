@@ -214,6 +214,10 @@ def setup_tests():
   build_current_module("module")
   os.chdir(cwd)
 
+  # Another requires a module to be compiled ahead of time
+  ensure_nibi_installed()
+  execute_command(["nibi", "--aot", "./tests/test_scripts/tests/compiled"])
+
 def run_tests():
   os.chdir("./tests/test_scripts")
   print("Running tests...")
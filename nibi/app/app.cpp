@@ -127,11 +127,17 @@ void show_help() {
   std::cout << "  -h, --help            Show this help message" << std::endl;
   std::cout << "  -v, --version         Show version info" << std::endl;
   std::cout << "  -m, --module <name>   Show module info" << std::endl;
+  std::cout << "  -a, --aot <module>    Compile a module's sources natively"
+            << std::endl;
   std::cout << "  -t, --test            Run tests" << std::endl;
   std::cout << "  -n, --no-std          Do not include standard symbols"
             << std::endl;
   std::cout << "  -i, --include <dirs>  Add include directory (`:` delimited)"
             << std::endl;
+  std::cout << "  -b, --no-bytecode     Do not lower code to bytecode"
+            << std::endl;
+  std::cout << "  -j, --no-jit          Do not compile hot lambdas natively"
+            << std::endl;
 }
 
 void show_version() {
@@ -190,6 +196,27 @@ void show_module_info(std::string module_name) {
   }
 }
 
+int compile_module(std::string target) {
+
+  // A module outside of the include directories is given by its path
+  auto fpd = std::filesystem::path(target);
+  if (std::filesystem::is_regular_file(fpd /
+                                       nibi::config::NIBI_MODULE_FILE_NAME)) {
+    fpd = std::filesystem::canonical(fpd);
+    pdc->add_include_dir(fpd.parent_path());
+    target = fpd.filename().string();
+  }
+
+  try {
+    auto library = module_factory_c::module_viewer()->compile_module(target);
+    std::cout << "Compiled: " << library.string() << std::endl;
+  } catch (nibi::interpreter_c::exception_c &e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
 void run_each_test(std::vector<std::filesystem::path> &files) {
 
   if (files.size() == 0) {
@@ -312,6 +339,16 @@ int main(int argc, char **argv) {
         continue;
       }
 
+      if (args[i] == "-b" || args[i] == "--no-bytecode") {
+        global_runtime_options.bytecode = false;
+        continue;
+      }
+
+      if (args[i] == "-j" || args[i] == "--no-jit") {
+        global_runtime_options.jit = false;
+        continue;
+      }
+
       if (args[i] == "-t" || args[i] == "--test") {
         if (i + 1 >= args.size()) {
           std::cout << "Error: Expected value for [-t | --test]" << std::endl;
@@ -331,6 +368,15 @@ int main(int argc, char **argv) {
         return 0;
       }
 
+      if (args[i] == "-a" || args[i] == "--aot") {
+        if (i + 1 >= args.size()) {
+          std::cout << "Error: Expected value for [-a | --aot]" << std::endl;
+          return 1;
+        }
+        pdc->add_include_dir(std::filesystem::current_path());
+        return compile_module(args[++i]);
+      }
+
       if (args[i] == "-i" || args[i] == "--include") {
         if (i + 1 >= args.size()) {
           std::cout << "Error: Expected value for [-i | --include]"
@@ -0,0 +1,366 @@
+#include "aot.hpp"
+#include "libnibi/version.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#ifndef NIBI_AOT_COMPILER
+#define NIBI_AOT_COMPILER "c++"
+#endif
+
+#ifndef NIBI_AOT_FLAGS
+#define NIBI_AOT_FLAGS "-std=c++20 -O2 -shared -fPIC"
+#endif
+
+#ifndef NIBI_AOT_LINK
+#define NIBI_AOT_LINK "-lnibi"
+#endif
+
+namespace nibi {
+namespace aot {
+
+namespace {
+
+using vm::instruction_s;
+using vm::op_e;
+
+class fnv_c {
+public:
+  void add(const void *data, std::size_t size) {
+    auto *bytes = static_cast<const uint8_t *>(data);
+    for (std::size_t i = 0; i < size; i++) {
+      hash_ = (hash_ ^ bytes[i]) * 0x100000001b3ull;
+    }
+  }
+
+  template <typename T> void add(T value) { add(&value, sizeof(value)); }
+
+  uint64_t get() const { return hash_; }
+
+private:
+  uint64_t hash_{0xcbf29ce484222325ull};
+};
+
+const char *name_of(op_e op) {
+  switch (op) {
+  case op_e::NOP:
+    return "NOP";
+  case op_e::MOVE:
+    return "MOVE";
+  case op_e::LOAD_CONST:
+    return "LOAD_CONST";
+  case op_e::LOAD_NIL:
+    return "LOAD_NIL";
+  case op_e::LOAD_LAST_RESULT:
+    return "LOAD_LAST_RESULT";
+  case op_e::LOAD_SYM:
+    return "LOAD_SYM";
+  case op_e::LOAD_SLOT:
+    return "LOAD_SLOT";
+  case op_e::EVAL:
+    return "EVAL";
+  case op_e::CALL:
+    return "CALL";
+  case op_e::ASSIGN:
+    return "ASSIGN";
+  case op_e::ASSIGN_SLOT:
+    return "ASSIGN_SLOT";
+  case op_e::SET:
+    return "SET";
+  case op_e::STEP:
+    return "STEP";
+  case op_e::ARITH:
+    return "ARITH";
+  case op_e::CMP:
+    return "CMP";
+  case op_e::NOT:
+    return "NOT";
+  case op_e::JUMP:
+    return "JUMP";
+  case op_e::JUMP_UNLESS:
+    return "JUMP_UNLESS";
+  case op_e::JUMP_IF_TERM:
+    return "JUMP_IF_TERM";
+  case op_e::ENTER_ENV:
+    return "ENTER_ENV";
+  case op_e::LEAVE_ENV:
+    return "LEAVE_ENV";
+  case op_e::PUSH_CTX:
+    return "PUSH_CTX";
+  case op_e::POP_CTX:
+    return "POP_CTX";
+  case op_e::YIELD:
+    return "YIELD";
+  case op_e::RETURN:
+    return "RETURN";
+  }
+  return "NOP";
+}
+
+bool is_jump(op_e op) {
+  return op == op_e::JUMP || op == op_e::JUMP_UNLESS ||
+         op == op_e::JUMP_IF_TERM || op == op_e::STEP;
+}
+
+std::string quoted(const std::string &text) {
+  std::string result = "\"";
+  for (auto c : text) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+
+// Each instruction is made a statement of its own, with the operands
+// held in a constant table so the compiler can fold them into the
+// machine's operations. Only instructions that are jumped to are
+// labelled, as the rest are reached by falling through
+void translate_body(std::ostringstream &out, std::size_t index,
+                    const body_s &body) {
+  auto &code = body.chunk->code;
+
+  std::set<std::size_t> targets;
+  for (auto &ins : code) {
+    if (is_jump(ins.op)) {
+      targets.insert(ins.a);
+    }
+  }
+
+  out << "// " << body.name << "\n";
+  out << "cell_ptr body_" << index
+      << "(interpreter_c &ci, vm::chunk_c &chunk, env_c &env) {\n";
+  out << "  [[maybe_unused]] static constexpr vm::instruction_s code[] = {\n";
+  for (auto &ins : code) {
+    out << "      {op_e::" << name_of(ins.op) << ", " << (int)ins.flag << ", "
+        << ins.a << ", " << ins.b << ", " << ins.c << ", " << ins.d
+        << "},\n";
+  }
+  out << "  };\n\n";
+  out << "  if (ci.is_completing()) {\n"
+      << "    return ci.get_completion_value();\n"
+      << "  }\n\n";
+  out << "  vm::machine_c m(ci, chunk, env);\n";
+
+  // As in vm::execute, errors are traced by the instruction that
+  // raised them once they leave the body
+  out << "  std::size_t pc{0};\n"
+      << "  try {\n";
+
+  std::ostringstream body_out;
+  for (std::size_t pc = 0; pc < code.size(); pc++) {
+    auto &ins = code[pc];
+    if (targets.contains(pc)) {
+      body_out << "L" << pc << ":\n";
+    }
+    if (ins.op != op_e::NOP && ins.op != op_e::JUMP) {
+      body_out << "  pc = " << pc << ";\n";
+    }
+
+    auto operation = [&](const char *name) {
+      return std::string("m.") + name + "(code[" + std::to_string(pc) + "])";
+    };
+    auto jump = "goto L" + std::to_string(ins.a) + ";";
+
+    switch (ins.op) {
+    case op_e::NOP:
+      break;
+    case op_e::MOVE:
+      body_out << "  " << operation("move") << ";\n";
+      break;
+    case op_e::LOAD_CONST:
+      body_out << "  " << operation("load_const") << ";\n";
+      break;
+    case op_e::LOAD_NIL:
+      body_out << "  " << operation("load_nil") << ";\n";
+      break;
+    case op_e::LOAD_LAST_RESULT:
+      body_out << "  " << operation("load_last_result") << ";\n";
+      break;
+    case op_e::LOAD_SYM:
+      body_out << "  " << operation("load_sym") << ";\n";
+      break;
+    case op_e::LOAD_SLOT:
+      body_out << "  " << operation("load_slot") << ";\n";
+      break;
+    case op_e::EVAL:
+      body_out << "  if (" << operation("eval") << ") {\n"
+          << "    return m.completion();\n"
+          << "  }\n";
+      break;
+    case op_e::CALL:
+      body_out << "  if (" << operation("call") << ") {\n"
+          << "    return m.completion();\n"
+          << "  }\n";
+      break;
+    case op_e::ASSIGN:
+      body_out << "  " << operation("assign") << ";\n";
+      break;
+    case op_e::ASSIGN_SLOT:
+      body_out << "  " << operation("assign_slot") << ";\n";
+      break;
+    case op_e::SET:
+      body_out << "  " << operation("set") << ";\n";
+      break;
+    case op_e::STEP:
+      body_out << "  if (" << operation("step") << ") {\n"
+          << "    " << jump << "\n"
+          << "  }\n";
+      break;
+    case op_e::ARITH:
+      body_out << "  " << operation("arith") << ";\n";
+      break;
+    case op_e::CMP:
+      body_out << "  " << operation("cmp") << ";\n";
+      break;
+    case op_e::NOT:
+      body_out << "  " << operation("negate") << ";\n";
+      break;
+    case op_e::JUMP:
+      body_out << "  " << jump << "\n";
+      break;
+    case op_e::JUMP_UNLESS:
+      body_out << "  if (!" << operation("truthy") << ") {\n"
+          << "    " << jump << "\n"
+          << "  }\n";
+      break;
+    case op_e::JUMP_IF_TERM:
+      body_out << "  if (m.terminating()) {\n"
+          << "    " << jump << "\n"
+          << "  }\n";
+      break;
+    case op_e::ENTER_ENV:
+      body_out << "  m.enter_env();\n";
+      break;
+    case op_e::LEAVE_ENV:
+      body_out << "  m.leave_env();\n";
+      break;
+    case op_e::PUSH_CTX:
+      body_out << "  m.push_ctx();\n";
+      break;
+    case op_e::POP_CTX:
+      body_out << "  m.pop_ctx();\n";
+      break;
+    case op_e::YIELD:
+      body_out << "  return " << operation("yield") << ";\n";
+      break;
+    case op_e::RETURN:
+      body_out << "  return " << operation("ret") << ";\n";
+      break;
+    }
+  }
+
+  std::istringstream lines(body_out.str());
+  for (std::string line; std::getline(lines, line);) {
+    out << "  " << line << "\n";
+  }
+  out << "  } catch (...) {\n"
+      << "    m.trace(pc);\n"
+      << "    throw;\n"
+      << "  }\n"
+      << "}\n\n";
+}
+
+} // namespace
+
+uint64_t fingerprint(const vm::chunk_c &chunk) {
+  fnv_c hash;
+  hash.add(ABI);
+  for (auto &ins : chunk.code) {
+    hash.add(ins.op);
+    hash.add(ins.flag);
+    hash.add(ins.a);
+    hash.add(ins.b);
+    hash.add(ins.c);
+    hash.add(ins.d);
+  }
+  for (auto &constant : chunk.constants) {
+    hash.add(constant->type);
+  }
+  hash.add(chunk.caches.size());
+  hash.add(chunk.num_registers);
+  hash.add(chunk.max_env_depth);
+  return hash.get();
+}
+
+uint64_t hash_files(const std::vector<std::filesystem::path> &files) {
+  fnv_c hash;
+  for (auto &file : files) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+      return 0;
+    }
+    std::string contents((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    hash.add(contents.data(), contents.size());
+    hash.add(contents.size());
+  }
+  return hash.get();
+}
+
+bool can_translate(const vm::chunk_c &chunk) {
+  if (chunk.code.empty()) {
+    return false;
+  }
+  for (auto &ins : chunk.code) {
+    if (is_jump(ins.op) && ins.a >= chunk.code.size()) {
+      return false;
+    }
+  }
+  auto last = chunk.code.back().op;
+  return last == op_e::RETURN || last == op_e::YIELD || last == op_e::JUMP;
+}
+
+std::string translate(const std::string &module_name, uint64_t sources_hash,
+                      const std::vector<body_s> &bodies) {
+  std::ostringstream out;
+  out << "// Compiled from the sources of module `" << module_name
+      << "` by nibi --aot\n"
+      << "// Generated code, compile the module again rather than edit it\n\n"
+      << "#include \"libnibi/aot.hpp\"\n"
+      << "#include \"libnibi/interpreter/vm/machine.hpp\"\n\n"
+      << "using namespace nibi;\n"
+      << "using vm::op_e;\n\n"
+      << "namespace {\n\n";
+
+  for (std::size_t i = 0; i < bodies.size(); i++) {
+    translate_body(out, i, bodies[i]);
+  }
+
+  out << "constexpr aot::entry_s entries[] = {\n";
+  for (std::size_t i = 0; i < bodies.size(); i++) {
+    out << "    {" << quoted(bodies[i].name) << ", body_" << i << ", "
+        << fingerprint(*bodies[i].chunk) << "ull},\n";
+  }
+  if (bodies.empty()) {
+    out << "    {\"\", nullptr, 0},\n";
+  }
+  out << "};\n\n";
+
+  out << "constexpr aot::manifest_s manifest = {" << ABI << ", "
+      << quoted(LIBNIBI_VERSION) << ", " << sources_hash << "ull, "
+      << bodies.size() << ", entries};\n\n"
+      << "} // namespace\n\n"
+      << "extern \"C\" const aot::manifest_s *" << MANIFEST_SYMBOL
+      << "() {\n"
+      << "  return &manifest;\n"
+      << "}\n";
+  return out.str();
+}
+
+std::string build_command(const std::filesystem::path &source,
+                          const std::filesystem::path &library) {
+  std::string compiler = NIBI_AOT_COMPILER;
+  if (auto cxx = std::getenv("CXX"); cxx && *cxx) {
+    compiler = cxx;
+  }
+  return compiler + " " + NIBI_AOT_FLAGS + " " + quoted(source.string()) +
+         " -o " + quoted(library.string()) + " " + NIBI_AOT_LINK;
+}
+
+} // namespace aot
+} // namespace nibi
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+#include "libnibi/interpreter/vm/bytecode.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/*
+    Modules can be compiled ahead of time with `nibi --aot <module>`,
+    which translates the lowered bodies of the lambdas their sources
+    define into C++ written against vm::machine_c, and builds that into
+    a library kept beside the sources.
+
+    The sources are still read when the module is loaded, as they give
+    the constants the bodies refer to. Each body is then handed the code
+    compiled for it iff the library was built against this version of
+    libnibi, from the same sources, and the body lowers to exactly the
+    instructions that were compiled. Anything else is left to the VM
+*/
+
+namespace nibi {
+
+class interpreter_c;
+
+namespace aot {
+
+//! \brief Changed whenever code compiled against an earlier version of
+//!        the machine would no longer behave the same
+static constexpr uint32_t ABI = 5;
+
+//! \brief The symbol the manifest of a compiled module is retrieved by
+static constexpr const char *MANIFEST_SYMBOL = "nibi_aot_manifest";
+
+//! \brief A lambda body compiled ahead of time, see vm::execute
+using body_f = compiled_body_f;
+
+//! \brief A body within a compiled module
+struct entry_s {
+  const char *name; // The name the lambda is bound to by the sources
+  body_f body;
+  uint64_t fingerprint; // See fingerprint()
+};
+
+//! \brief Describes what a compiled module was built from
+struct manifest_s {
+  uint32_t abi;
+  const char *version; // LIBNIBI_VERSION
+  uint64_t sources_hash; // See hash_files()
+  std::size_t count;
+  const entry_s *entries;
+};
+
+using manifest_f = const manifest_s *(*)();
+
+//! \brief A lambda body to translate
+struct body_s {
+  std::string name;
+  vm::chunk_ptr chunk;
+};
+
+//! \brief Hash the parts of a chunk that compiled code depends on
+//! \param chunk The chunk to hash
+//! \return The hash, which differs if the chunk lowers differently
+extern uint64_t fingerprint(const vm::chunk_c &chunk);
+
+//! \brief Hash the contents of a list of files
+//! \param files The files to hash, in order
+//! \return The hash, or 0 if any of the files can't be read
+extern uint64_t hash_files(const std::vector<std::filesystem::path> &files);
+
+//! \brief Check if a chunk can be translated
+//! \param chunk The chunk to check
+//! \return True iff no path through the chunk runs off its end
+extern bool can_translate(const vm::chunk_c &chunk);
+
+//! \brief Translate lambda bodies into the source of a compiled module
+//! \param module_name The name of the module the bodies are from
+//! \param sources_hash The hash of the sources of the module
+//! \param bodies The bodies to translate, each of which can_translate
+//! \return C++ source exporting the manifest of the module
+extern std::string translate(const std::string &module_name,
+                             uint64_t sources_hash,
+                             const std::vector<body_s> &bodies);
+
+//! \brief Get the command that builds translated source into a library
+//! \param source The translated source
+//! \param library The library to build
+//! \note  The compiler is taken from CXX if it is set, otherwise it is
+//!        the compiler libnibi was built with
+extern std::string build_command(const std::filesystem::path &source,
+                                 const std::filesystem::path &library);
+
+} // namespace aot
+} // namespace nibi
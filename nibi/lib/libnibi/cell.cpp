@@ -23,6 +23,17 @@ const char *function_type_to_string(function_type_e type) {
 }
 } // namespace
 
+std::string function_info_s::arity_error(std::size_t count) const {
+  std::string expected = std::to_string(arity.min);
+  if (arity.max == arity_s::ANY) {
+    expected = "at least " + expected;
+  } else if (arity.max != arity.min) {
+    expected += " to " + std::to_string(arity.max);
+  }
+  return name + " instruction expects " + expected + " parameters, got " +
+         std::to_string(count) + ".";
+}
+
 const char *cell_type_to_string(const cell_type_e type) {
   switch (type) {
   case cell_type_e::NIL:
@@ -72,6 +83,8 @@ const char *cell_type_to_string(const cell_type_e type) {
 }
 
 cell_c::~cell_c() {
+  set_location({});
+
   // Different types of cells may need to be manually cleaned up
   switch (this->type) {
   case cell_type_e::ABERRANT: {
@@ -85,6 +98,9 @@ cell_c::~cell_c() {
   // we need to clean the operating environment
   // as well because fauxs own their own
   case cell_type_e::FUNCTION: {
+    if (flags & SHARED_FN) {
+      break;
+    }
     auto &func_info = this->as_function_info();
     if (func_info.type == function_type_e::FAUX) {
       if (func_info.operating_env) {
@@ -96,18 +112,12 @@ cell_c::~cell_c() {
     this->data.fn = nullptr;
     break;
   }
-  case cell_type_e::SYMBOL: {
-    if (this->data.sym) {
-      delete this->data.sym;
-      this->data.sym = nullptr;
-    }
+  case cell_type_e::STRING: {
+    release_string();
     break;
   }
-  case cell_type_e::STRING: {
-    if (this->data.cstr) {
-      delete[] this->data.cstr;
-      this->data.cstr = nullptr;
-    }
+  case cell_type_e::SYMBOL: {
+    release_site();
     break;
   }
   case cell_type_e::ENVIRONMENT: {
@@ -125,14 +135,14 @@ cell_c::~cell_c() {
   }
   case cell_type_e::DICT: {
     if (this->data.dict) {
-      delete this->data.dict;
+      release_shared(this->data.dict);
       this->data.dict = nullptr;
     }
     break;
   }
   case cell_type_e::LIST: {
     if (this->data.list) {
-      delete this->data.list;
+      release_shared(this->data.list);
       this->data.list = nullptr;
     }
     break;
@@ -145,15 +155,36 @@ cell_c::~cell_c() {
 
 cell_ptr cell_c::clone(env_c &env, bool resolve_sym) {
 
+  // Shared functions can't be modified, so copies can share them too
+  if (flags & SHARED_FN) {
+    cell_ptr new_cell = allocate_cell(shared_function_s{this->data.fn});
+    new_cell->set_location(this->get_location());
+    return new_cell;
+  }
+
+  // Lists and dicts that own their cells are shared by the copy until
+  // either is modified, see as_list_info
+  if ((this->type == cell_type_e::LIST && this->data.list->owned) ||
+      (this->type == cell_type_e::DICT && this->data.dict &&
+       this->data.dict->owned)) {
+    cell_ptr new_cell = allocate_cell(cell_type_e::NIL);
+    new_cell->set_location(this->get_location());
+    new_cell->type = this->type;
+    if (this->type == cell_type_e::LIST) {
+      new_cell->data.list = this->data.list;
+      this->data.list->shares++;
+    } else {
+      new_cell->data.dict = this->data.dict;
+      this->data.dict->shares++;
+    }
+    return new_cell;
+  }
+
   // Allocate a new cell
   cell_ptr new_cell = allocate_cell(this->type);
 
   // Copy the data
-  if (this->locator) {
-    new_cell->locator = this->locator->clone();
-  } else {
-    new_cell->locator = nullptr;
-  }
+  new_cell->set_location(this->get_location());
 
   switch (this->type) {
   case cell_type_e::NIL:
@@ -201,16 +232,16 @@ cell_ptr cell_c::clone(env_c &env, bool resolve_sym) {
     break;
   }
   case cell_type_e::SYMBOL: {
-    auto referenced_symbol = env.get(this->as_symbol());
-    if (resolve_sym && referenced_symbol != nullptr) {
+    auto referenced_symbol = resolve_sym ? env.get(this->data.sym.id) : nullptr;
+    if (referenced_symbol != nullptr) {
       new_cell = referenced_symbol->clone(env, resolve_sym);
     } else {
-      new_cell->data.sym->value = this->as_symbol();
+      new_cell->data.sym = {this->data.sym.id, 0};
     }
     break;
   }
   case cell_type_e::STRING:
-    new_cell->update_string(this->to_string());
+    new_cell->share_string(*this);
     break;
   case cell_type_e::FUNCTION: {
 
@@ -218,8 +249,10 @@ cell_ptr cell_c::clone(env_c &env, bool resolve_sym) {
 
     new_cell->data.fn->name = func_info.name;
     new_cell->data.fn->fn = func_info.fn;
+    new_cell->data.fn->eager = func_info.eager;
     new_cell->data.fn->type = func_info.type;
     new_cell->data.fn->isolate = func_info.isolate;
+    new_cell->data.fn->macro = func_info.macro;
 
     if (func_info.type == function_type_e::FAUX && func_info.operating_env) {
       new_cell->as_function_info().operating_env = new env_c();
@@ -239,28 +272,43 @@ cell_ptr cell_c::clone(env_c &env, bool resolve_sym) {
       // off.
       (*new_cell->as_function_info().lambda).body =
           (*func_info.lambda).body->clone(env, false);
+
+      // The lowered body refers to the original cells, so it
+      // will be lowered again from the clone if it is ever called
+      (*new_cell->as_function_info().lambda).chunk = nullptr;
+      (*new_cell->as_function_info().lambda).chunk_attempted = false;
     }
     break;
   }
   case cell_type_e::LIST: {
-    auto &linf = this->as_list_info();
+    auto &linf = this->read_list_info();
     auto &other = new_cell->as_list_info();
     other.type = linf.type;
+    bool owned = linf.type == list_types_e::DATA;
     for (auto &cell : linf.list) {
       other.list.push_back(cell->clone(env, resolve_sym));
+      owned = owned && other.list.back()->can_be_owned();
     }
+    other.owned = owned;
     break;
   }
   case cell_type_e::ENVIRONMENT: {
-    throw cell_access_exception_c("Cannot clone an environment", this->locator);
+    throw cell_access_exception_c("Cannot clone an environment",
+                                  this->get_location());
     break;
   }
   case cell_type_e::DICT: {
-    auto &dinf = this->as_dict();
-    auto &other = new_cell->as_dict();
-    for (auto &pair : dinf) {
-      other[pair.first] = pair.second->clone(env, resolve_sym);
+    new_cell->data.dict = new dict_info_s();
+    if (!this->data.dict) {
+      break;
     }
+    auto &other = new_cell->data.dict->data;
+    bool owned = true;
+    for (auto &pair : this->read_dict()) {
+      auto &cell = other[pair.first] = pair.second->clone(env, resolve_sym);
+      owned = owned && cell->can_be_owned();
+    }
+    new_cell->data.dict->owned = owned;
     break;
   }
   case cell_type_e::ABERRANT: {
@@ -269,7 +317,7 @@ cell_ptr cell_c::clone(env_c &env, bool resolve_sym) {
       throw cell_access_exception_c(
           std::string("Cannot clone given aberrant: ") +
               this->data.aberrant->represent_as_string(),
-          this->locator);
+          this->get_location());
     }
     new_cell->data.aberrant = cloned;
     break;
@@ -278,6 +326,93 @@ cell_ptr cell_c::clone(env_c &env, bool resolve_sym) {
   return new_cell;
 }
 
+void cell_c::unshare() {
+  // The cells of what's shared are reachable from nowhere else and
+  // hold no symbols, so they are copied the same from any environment
+  static env_c unbound;
+
+  if (type == cell_type_e::LIST) {
+    auto *shared = data.list;
+    auto *own = new list_info_s(shared->type);
+    for (auto &cell : shared->list) {
+      own->list.push_back(cell->clone(unbound, false));
+    }
+    own->owned = true;
+    shared->shares--;
+    data.list = own;
+    return;
+  }
+
+  auto *shared = data.dict;
+  auto *own = new dict_info_s();
+  for (auto &pair : shared->data) {
+    own->data[pair.first] = pair.second->clone(unbound, false);
+  }
+  own->owned = true;
+  shared->shares--;
+  data.dict = own;
+}
+
+namespace {
+// Counted strings are preceded by the number of other cells sharing them
+constexpr std::size_t STRING_COUNT_SIZE = sizeof(std::size_t);
+
+std::size_t &string_shares(char *cstr) {
+  return *reinterpret_cast<std::size_t *>(cstr - STRING_COUNT_SIZE);
+}
+
+char *allocate_counted_string(const char *data, std::size_t size) {
+  auto *cstr = new char[STRING_COUNT_SIZE + size + 1] + STRING_COUNT_SIZE;
+  string_shares(cstr) = 0;
+  memcpy(cstr, data, size);
+  cstr[size] = '\0';
+  return cstr;
+}
+} // namespace
+
+void cell_c::update_string(const std::string &data) {
+  if (this->type != cell_type_e::STRING) {
+    throw cell_access_exception_c("Cell does not contain a string to update",
+                                  this->get_location());
+  }
+  release_string();
+  this->data.cstr = allocate_counted_string(data.data(), data.size());
+  flags |= COUNTED_STR;
+}
+
+void cell_c::share_string(cell_c &other) {
+  if (!other.data.cstr || !(other.flags & COUNTED_STR)) {
+    auto *cstr = other.data.cstr ? other.data.cstr : "";
+    this->data.cstr = allocate_counted_string(cstr, strlen(cstr));
+  } else {
+    this->data.cstr = other.data.cstr;
+    string_shares(this->data.cstr)++;
+  }
+  flags |= COUNTED_STR;
+}
+
+void cell_c::release_string() {
+  if (!this->data.cstr) {
+    return;
+  }
+  if (!(flags & COUNTED_STR)) {
+    delete[] this->data.cstr;
+  } else if (string_shares(this->data.cstr)) {
+    string_shares(this->data.cstr)--;
+  } else {
+    delete[] (this->data.cstr - STRING_COUNT_SIZE);
+  }
+  this->data.cstr = nullptr;
+  flags &= ~COUNTED_STR;
+}
+
+void cell_c::release_site() {
+  if (this->data.sym.site) {
+    env_c::release_site(this->data.sym.site);
+    this->data.sym.site = 0;
+  }
+}
+
 std::string cell_c::to_string(bool quote_strings, bool flatten_complex) {
   switch (this->type) {
   case cell_type_e::NIL:
@@ -351,7 +486,7 @@ std::string cell_c::to_string(bool quote_strings, bool flatten_complex) {
     return result;
   }
   case cell_type_e::DICT: {
-    auto &dict = this->as_dict();
+    auto &dict = this->read_dict();
     std::string result = "{";
     for (auto &pair : dict) {
       result += pair.first + ":" + pair.second->to_string(quote_strings) + " ";
@@ -367,7 +502,7 @@ std::string cell_c::to_string(bool quote_strings, bool flatten_complex) {
   }
   case cell_type_e::LIST: {
     std::string result;
-    auto &list_info = this->as_list_info();
+    auto &list_info = this->read_list_info();
 
     switch (list_info.type) {
     case list_types_e::INSTRUCTION: {
@@ -404,7 +539,53 @@ std::string cell_c::to_string(bool quote_strings, bool flatten_complex) {
     return result;
   }
   }
-  throw cell_access_exception_c("Unknown cell type", this->locator);
+  throw cell_access_exception_c("Unknown cell type", this->get_location());
+}
+
+namespace {
+// Range of the integers that are shared, which covers
+// booleans, small counters and indexes
+static constexpr int64_t SHARED_INTEGER_MIN = -128;
+static constexpr int64_t SHARED_INTEGER_MAX = 1023;
+
+struct constant_pool_s {
+  cell_ptr nil;
+  std::vector<cell_ptr> integers;
+
+  constant_pool_s() {
+    nil = allocate_cell(cell_type_e::NIL);
+    nil->make_immortal();
+    integers.reserve(SHARED_INTEGER_MAX - SHARED_INTEGER_MIN + 1);
+    for (auto i = SHARED_INTEGER_MIN; i <= SHARED_INTEGER_MAX; i++) {
+      auto &cell = integers.emplace_back(allocate_cell(i));
+      cell->make_immortal();
+    }
+  }
+};
+
+constant_pool_s &constant_pool() {
+  static constant_pool_s pool;
+  return pool;
+}
+} // namespace
+
+cell_ptr constant_nil() { return constant_pool().nil; }
+
+cell_ptr constant_integer(int64_t value) {
+  if (value < SHARED_INTEGER_MIN || value > SHARED_INTEGER_MAX) {
+    return allocate_cell(value);
+  }
+  return constant_pool().integers[value - SHARED_INTEGER_MIN];
+}
+
+cell_ptr writable_cell(const cell_ptr &cell) {
+  if (!cell->is_constant()) {
+    return cell;
+  }
+  // Constants are only ever nil or integers
+  auto copy = allocate_cell(cell->type);
+  copy->data = cell->data;
+  return copy;
 }
 
 } // namespace nibi
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "libnibi/RLL/rll_wrapper.hpp"
+#include "libnibi/collector.hpp"
+#include "libnibi/slab.hpp"
 #include "libnibi/source.hpp"
+#include "libnibi/symbols.hpp"
 #include "ref.hpp"
 #include <any>
 #include <cassert>
@@ -10,10 +13,13 @@
 #include <exception>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #define CELL_LIST_USE_STD_VECTOR 1
 
@@ -33,7 +39,7 @@ static constexpr uint8_t CELL_TYPE_MIN_NUMERIC = 0x01;
 static constexpr uint8_t CELL_TYPE_MIN_INTEGER = CELL_TYPE_MIN_NUMERIC;
 static constexpr uint8_t CELL_TYPE_MAX_INTEGER = 0x10;
 static constexpr uint8_t CELL_TYPE_MAX_NUMERIC = 0xB0;
-static constexpr uint8_t CELL_TYPE_MIN_FLOAT = CELL_TYPE_MAX_NUMERIC - 1;
+static constexpr uint8_t CELL_TYPE_MIN_FLOAT = CELL_TYPE_MAX_INTEGER + 1;
 static constexpr uint8_t CELL_TYPE_MAX_FLOAT = CELL_TYPE_MAX_NUMERIC;
 static constexpr uint8_t CELL_TYPE_MAX_TRIVIAL = 0xF0;
 
@@ -52,8 +58,8 @@ enum class cell_type_e : uint8_t {
   I16,
   I32,
   I64 = CELL_TYPE_MAX_INTEGER,
-  F32,
-  F64 = CELL_TYPE_MAX_NUMERIC,
+  F32 = CELL_TYPE_MIN_FLOAT,
+  F64 = CELL_TYPE_MAX_FLOAT,
   CHAR,
   STRING = CELL_TYPE_MAX_TRIVIAL,
   LIST,
@@ -109,6 +115,14 @@ class interpreter_c;
 class interpreter_c;
 class cell_c;
 
+namespace vm {
+class chunk_c;
+}
+
+namespace jit {
+class function_c;
+}
+
 //! \brief A cell pointer type
 using cell_ptr = ref_counted_ptr_c<cell_c>;
 
@@ -121,24 +135,79 @@ using cell_list_t = std::deque<cell_ptr>;
 #endif
 
 //! \brief A function that takes a list of cells and an environment
-using cell_fn_t =
-    std::function<cell_ptr(interpreter_c &ci, cell_list_t &, env_c &)>;
+//! \note  This is a plain pointer so that a call is a single indirect
+//!        call. Anything a function closes over is reached through the
+//!        operating environment of its function_info_s
+using cell_fn_t = cell_ptr (*)(interpreter_c &ci, cell_list_t &, env_c &);
+
+//! \brief The evaluated arguments of a call, see cell_eager_fn_t
+//! \note  The arguments are borrowed from the interpreter's operand stack,
+//!        which holds them until the call returns. A function only takes
+//!        a reference of its own to an argument that it keeps, as when
+//!        it is bound into an environment or held by a list
+using cell_args_t = std::span<const cell_ptr>;
+
+//! \brief A function that is given its arguments evaluated
+//! \note  Such a function must not evaluate anything itself, so that the
+//!        operand stack can't move the arguments it is given. Builtins
+//!        that take their arguments this way also have a cell_fn_t that
+//!        evaluates them, see builtins::evaluated
+using cell_eager_fn_t = cell_ptr (*)(interpreter_c &ci, cell_args_t args,
+                                     env_c &);
 
 //! \brief A dictionary type
 using cell_dict_t = std::unordered_map<std::string, cell_ptr>;
 
-struct dict_info_s {
+struct dict_info_s : collector::tracked_c {
+  NIBI_SLAB_ALLOCATED
   cell_dict_t data;
-  dict_info_s() = default;
-  dict_info_s(const dict_info_s &other) : data(other.data) {};
-  dict_info_s(cell_dict_t other) : data(std::move(other)) {};
+  uint32_t shares{0}; // Other cells holding the dict, see cell_c::clone
+  bool owned{false};  // Its cells are reachable only through the dict
+  dict_info_s() : tracked_c(kind_e::DICT) {};
+  dict_info_s(const dict_info_s &other)
+      : tracked_c(kind_e::DICT), data(other.data) {};
+  dict_info_s(cell_dict_t other)
+      : tracked_c(kind_e::DICT), data(std::move(other)) {};
 };
 static constexpr uint8_t DICT_ID_FLAG = 24;
 
+//! \brief A lambda body compiled ahead of time, see aot.hpp
+using compiled_body_f = cell_ptr (*)(interpreter_c &, vm::chunk_c &,
+                                     env_c &);
+
 //! \brief Lambda information that can be encoded into a cell
 struct lambda_info_s {
   std::vector<std::string> arg_names;
+  std::vector<symbol_id_t> slot_symbols; // Parameters, then top level locals
   cell_ptr body{nullptr};
+  std::shared_ptr<vm::chunk_c> chunk{nullptr}; // Lowered body, if any
+  bool chunk_attempted{false};
+  std::size_t calls{0};
+  std::shared_ptr<jit::function_c> native{nullptr}; // Compiled chunk, if any
+  bool native_attempted{false};
+  compiled_body_f compiled{nullptr}; // Chunk compiled ahead of time, if any
+};
+
+//! \brief Macro information that can be encoded into a cell
+//! \note  The body is held as the cells it was written as, and is
+//!        expanded by substituting the arguments of a call for the
+//!        symbols of its parameters. Expansions are kept for the
+//!        call site they were made for, and each call executes a copy
+//!        of one unless nothing it holds can be modified, see
+//!        assemble_macro
+struct macro_info_s {
+  //! \brief A body expanded for a call site
+  struct expansion_s {
+    cell_list_t args; // The arguments the body was expanded with
+    cell_list_t body;
+    std::vector<std::optional<std::shared_ptr<vm::chunk_c>>> lowered;
+    bool in_place{false}; // The body holds no data lists to be modified
+  };
+
+  std::vector<symbol_id_t> params; // `%` followed by each parameter name
+  cell_list_t body;
+  std::unordered_map<const cell_list_t *, std::shared_ptr<expansion_s>>
+      expansions;
 };
 
 //! \brief Function wrapper that holds the function
@@ -146,49 +215,111 @@ struct lambda_info_s {
 //! \note  The operating env is a raw pointer as it may
 //!        be owned by the cell or not. Lambdas for instance
 //!        point to the environment they were defined in
-//!        but do not own it, while MACROS own the environment
+//!        but do not own it, while FAUX functions own the environment
 //!        to hold onto construction this->data. While two pointers
 //!        or a further wrapper could be used, this is lighter
 struct function_info_s {
+  NIBI_SLAB_ALLOCATED
+
+  //! \brief The number of arguments a function can be called with
+  struct arity_s {
+    static constexpr std::size_t ANY = std::numeric_limits<std::size_t>::max();
+    std::size_t min{0};
+    std::size_t max{ANY};
+    bool accepts(std::size_t count) const {
+      return count >= min && count <= max;
+    }
+  };
+
+  //! \brief Describe a call with a number of arguments the function
+  //!        doesn't accept
+  std::string arity_error(std::size_t count) const;
+
   std::string name;
   cell_fn_t fn;
   function_type_e type;
+  arity_s arity; // Checked before the function is called
+  cell_eager_fn_t eager{nullptr}; // Takes the arguments evaluated, if set
   std::optional<lambda_info_s> lambda{std::nullopt};
+  std::shared_ptr<macro_info_s> macro{nullptr}; // Shared by copies
   env_c *operating_env{nullptr};
   bool isolate{false}; // Set this flag to explicitly clone all params on call
   function_info_s() : name(""), fn(nullptr), type(function_type_e::UNSET) {};
   function_info_s(std::string name, cell_fn_t fn, function_type_e type,
                   env_c *env = nullptr)
       : name(name), fn(fn), type(type), operating_env(env) {}
+  function_info_s(std::string name, cell_fn_t fn, function_type_e type,
+                  arity_s arity, cell_eager_fn_t eager = nullptr)
+      : name(name), fn(fn), type(type), arity(arity), eager(eager) {}
+};
+
+//! \brief Wrapper to create a function cell that refers to a function
+//!        rather than owning a copy of it
+//! \note  The function must outlive every cell that refers to it and
+//!        must not be modified through them. Builtins are referred to
+//!        this way, as every instruction calling one holds a cell for it
+struct shared_function_s {
+  function_info_s *info;
+};
+
+//! \brief Inline cache of the binding a symbol was resolved to
+//! \note  Only valid while its epoch matches that of env_c, and for
+//!        sites within a frame of the same shape, see env_c::get
+struct binding_cache_s {
+  cell_ptr *binding{nullptr};
+  std::size_t epoch{0};
+  const std::vector<symbol_id_t> *shape{nullptr}; // Slots of the frame
 };
 
 //! \brief List wrapper that holds list meta data
-struct list_info_s {
+struct list_info_s : collector::tracked_c {
+  NIBI_SLAB_ALLOCATED
   list_types_e type;
+  uint32_t shares{0}; // Other cells holding the list, see cell_c::clone
+  bool owned{false};  // Its cells are reachable only through the list
   cell_list_t list;
+  binding_cache_s head_cache; // Resolution of an instruction's operation
   list_info_s(list_types_e type, cell_list_t list)
-      : type(type), list(std::move(list)) {}
+      : tracked_c(kind_e::LIST), type(type), list(std::move(list)) {}
+
+  // A copy holds the same cells, so it owns none of them
+  list_info_s(const list_info_s &other)
+      : tracked_c(kind_e::LIST), type(other.type), list(other.list),
+        head_cache(other.head_cache) {}
+  list_info_s(list_info_s &&other)
+      : tracked_c(kind_e::LIST), type(other.type), owned(other.owned),
+        list(std::move(other.list)), head_cache(other.head_cache) {}
 
-  list_info_s(list_types_e type) : type(type) {
+  list_info_s(list_types_e type) : tracked_c(kind_e::LIST), type(type) {
 #if CELL_LIST_USE_STD_VECTOR
     list.reserve(CELL_VEC_RESERVE_SIZE);
 #endif
   }
 };
 
+//! \brief The data of a symbol cell
+//! \note  The site is owned by the cell, and is never copied with it
+struct symbol_ref_s {
+  symbol_id_t id;
+  uint32_t site; // Cache of where the cell was last read from, see env_c::read
+};
+
 struct symbol_s {
-  std::string value;
+  symbol_id_t id{symbols::EMPTY};
   symbol_s() = default;
-  symbol_s(const std::string &v) : value(v) {}
+  symbol_s(const std::string &v) : id(symbols::intern(v)) {}
+  symbol_s(symbol_id_t id) : id(id) {}
 };
 
 // Temporary wrapper to distinguish aliases
 struct alias_s {
+  NIBI_SLAB_ALLOCATED
   cell_ptr cell;
 };
 
 //! \brief Environment information that can be encoded into a cell
 struct environment_info_s {
+  NIBI_SLAB_ALLOCATED
   std::string name;
   std::shared_ptr<env_c> env{nullptr};
 };
@@ -200,18 +331,18 @@ public:
   //! \brief Create the exception
   //! \param message The message to display
   //! \param source_location The location in the source code
-  cell_access_exception_c(std::string message, locator_ptr source_location)
+  cell_access_exception_c(std::string message, location_s source_location)
       : message_(message), source_location_(source_location) {}
 
   //! \brief Get the message
   char *what() { return const_cast<char *>(message_.c_str()); }
 
   //! \brief Get the source location
-  locator_ptr get_source_location() const { return source_location_; }
+  location_s get_source_location() const { return source_location_; }
 
 private:
   std::string message_;
-  locator_ptr source_location_;
+  location_s source_location_;
 };
 
 //! \brief A cell type that can be used to store data
@@ -258,15 +389,36 @@ private:
   std::size_t tag_{0};
 };
 
-#pragma pack(push, 1)
-
 //! \brief A cell
+//! \note  Cells are laid out as a 16 byte header and payload, the
+//!        reference count, type and flags followed by the data, so
+//!        that four fit in a cache line. Their source location is
+//!        rarely needed and is kept to the side by the allocator.
 class cell_c : public ref_counted_c {
 public:
+  NIBI_SLAB_ALLOCATED
+
+  //! \brief Flags describing the cell rather than its data
+  enum flags_e : uint8_t {
+    LOCATED = 1 << 0,     //! A source location is stored for the cell
+    SCOPE_KNOWN = 1 << 1, //! The scope the instruction this cell heads,
+                          //! or the call it is, needs has been
+                          //! determined, as below
+    SCOPE_ENV = 1 << 2,   //! Something within it binds into its scope
+    SCOPE_CTX = 1 << 3,   //! Something within it defers to its context
+    SHARED_FN = 1 << 4,   //! The function is not owned, see shared_function_s
+    VERIFIED = 1 << 5,    //! The arguments of the instruction were checked
+                          //! against the builtin it calls when it was read
+    COUNTED_STR = 1 << 6, //! The string carries a count of the cells
+                          //! sharing it, see update_string
+    COLLECTING = 1 << 7,  //! Seen by the collection in progress, see
+                          //! collector.cpp
+  };
+
   cell_type_e type{cell_type_e::NIL};
-  locator_ptr locator{nullptr};
+  uint8_t flags{0};
 
-  union {
+  union data_u {
     void *ptr;
     char *cstr;
     char ch;
@@ -286,7 +438,7 @@ public:
     alias_s *alias;
     dict_info_s *dict;
     list_info_s *list;
-    symbol_s *sym;
+    symbol_ref_s sym;
   } data{0};
 
   cell_c(int8_t data) : type(cell_type_e::I8) { this->data.i8 = data; }
@@ -302,13 +454,13 @@ public:
   cell_c(char data) : type(cell_type_e::CHAR) { this->data.ch = data; }
   cell_c(std::string data) : type(cell_type_e::STRING) { update_string(data); }
   cell_c(symbol_s data) : type(cell_type_e::SYMBOL) {
-    this->data.sym = new symbol_s{data.value};
+    this->data.sym = {data.id, 0};
   }
   cell_c(alias_s alias) : type(cell_type_e::ALIAS) {
     this->data.alias = new alias_s(alias);
   }
   cell_c(list_info_s list) : type(cell_type_e::LIST) {
-    this->data.list = new list_info_s(list);
+    this->data.list = new list_info_s(std::move(list));
   }
   cell_c(aberrant_cell_if *acif) : type(cell_type_e::ABERRANT) {
     this->data.aberrant = acif;
@@ -316,6 +468,10 @@ public:
   cell_c(function_info_s fn) : type(cell_type_e::FUNCTION) {
     this->data.fn = new function_info_s(fn);
   }
+  cell_c(shared_function_s fn)
+      : type(cell_type_e::FUNCTION), flags(SHARED_FN) {
+    this->data.fn = fn.info;
+  }
   cell_c(environment_info_s env) : type(cell_type_e::ENVIRONMENT) {
     this->data.env = new environment_info_s(env);
   }
@@ -323,7 +479,7 @@ public:
     this->data.dict = new dict_info_s(dict);
   }
 
-  virtual ~cell_c();
+  ~cell_c();
 
   cell_c() = delete;
   cell_c(const cell_c &other) = delete;
@@ -342,8 +498,46 @@ public:
                         bool flatten_complex = false);
 
   //! \brief Deep copy the cell
+  //! \note  Strings, and lists and dicts that own their cells, are
+  //!        shared with the copy until either of them is modified
   cell_ptr clone(env_c &env, bool resolve_sym = true);
 
+  //! \brief Check if the cell can be held by a list or dict that owns
+  //!        its cells, so that copies of them can share it
+  //! \note  Symbols are resolved as they are copied, so they can't be
+  bool can_be_owned() const {
+    switch (type) {
+    case cell_type_e::SYMBOL:
+    case cell_type_e::ALIAS:
+    case cell_type_e::ENVIRONMENT:
+      return false;
+    case cell_type_e::LIST:
+      return data.list->owned;
+    case cell_type_e::DICT:
+      return data.dict && data.dict->owned;
+    default:
+      return true;
+    }
+  }
+
+  //! \brief Get the location of the source the cell came from
+  location_s get_location() const {
+    if (!(flags & LOCATED)) {
+      return {};
+    }
+    return location_s::from_packed(
+        slab::get_side_word(this, sizeof(cell_c)));
+  }
+
+  //! \brief Set the location of the source the cell came from
+  void set_location(location_s location) {
+    if (!location && !(flags & LOCATED)) {
+      return;
+    }
+    slab::set_side_word(this, sizeof(cell_c), location.get_packed());
+    flags = location ? (flags | LOCATED) : (flags & ~LOCATED);
+  }
+
   //! \brief Create a cell with a given type
   cell_c(cell_type_e type) : type(type) {
     // Initialize the data based on given type
@@ -379,7 +573,7 @@ public:
       this->data.cstr = nullptr;
       break;
     case cell_type_e::SYMBOL:
-      this->data.sym = new symbol_s();
+      this->data.sym = {symbols::EMPTY, 0};
       break;
     case cell_type_e::LIST:
       this->data.list = new list_info_s(list_types_e::DATA);
@@ -398,39 +592,11 @@ public:
 
   void update_from(cell_c &other, env_c &env) {
 
-    // Perform any cleanup of this cell required before updating to new data
-
-    if (this->type == cell_type_e::ENVIRONMENT ||
-        this->type == cell_type_e::ABERRANT ||
-        other.type == cell_type_e::ENVIRONMENT ||
-        other.type == cell_type_e::ABERRANT) {
-      throw cell_access_exception_c("Reallocating to/from a Nibi envrionment "
-                                    "or aberrant cell is an illegal operation",
-                                    this->locator);
-    }
-
-    // Note we don't run update_from on symbol types, but if we
-    // did we would need to extend this
-
-    if (this->type == cell_type_e::STRING && this->data.cstr) {
-      delete[] this->data.cstr;
-    }
-
-    if (this->type == cell_type_e::FUNCTION && this->data.fn) {
-      delete this->data.fn;
-    }
-
-    if (this->type == cell_type_e::LIST && this->data.list) {
-      delete this->data.list;
-    }
-
-    if (this->type == cell_type_e::DICT && this->data.dict) {
-      delete this->data.dict;
+    if (&other == this) {
+      return;
     }
 
-    if (this->type == cell_type_e::SYMBOL && this->data.sym) {
-      delete this->data.sym;
-    }
+    release_for_update(other.type);
 
     // Set this cell's new type
 
@@ -439,10 +605,7 @@ public:
     // Handle specific copies
 
     if (other.type == cell_type_e::STRING) {
-      auto size = strlen(other.data.cstr);
-      this->data.cstr = new char[size + 1];
-      strncpy(this->data.cstr, other.data.cstr, size);
-      this->data.cstr[size] = '\0';
+      share_string(other);
       return;
     }
 
@@ -451,13 +614,15 @@ public:
       return;
     }
 
+    // Take the list or dict of a copy, which the copy may share
+
     if (other.type == cell_type_e::LIST && other.data.list) {
-      this->data.list = new list_info_s(*(other.clone(env)->data.list));
+      this->data.list = std::exchange(other.clone(env)->data.list, nullptr);
       return;
     }
 
     if (other.type == cell_type_e::DICT && other.data.dict) {
-      this->data.dict = new dict_info_s(*(other.clone(env)->data.dict));
+      this->data.dict = std::exchange(other.clone(env)->data.dict, nullptr);
       return;
     }
 
@@ -466,8 +631,8 @@ public:
       return;
     }
 
-    if (other.type == cell_type_e::SYMBOL && other.data.sym) {
-      this->data.sym = new symbol_s(other.data.sym->value);
+    if (other.type == cell_type_e::SYMBOL) {
+      this->data.sym = {other.data.sym.id, 0};
       return;
     }
 
@@ -476,6 +641,17 @@ public:
     this->data = other.clone(env)->data;
   }
 
+  //! \brief Update the cell to hold a number, char, or nil
+  //! \param type The type of the value
+  //! \param value The data of the value
+  //! \note Updates from values that were never allocated into
+  //!       a cell of their own
+  void update_from(cell_type_e type, data_u value) {
+    release_for_update(type);
+    this->type = type;
+    this->data = value;
+  }
+
   int64_t to_integer() {
     if (is_float()) {
       return (int64_t)this->as_double();
@@ -483,12 +659,12 @@ public:
     return this->as_integer();
   }
 
-  int64_t &as_integer() {
+  int64_t as_integer() {
     if (!is_integer()) {
       throw cell_access_exception_c(
-          "Cell is not an integer: " + this->to_string(), this->locator);
+          "Cell is not an integer: " + this->to_string(), this->get_location());
     }
-    return data.i64;
+    return integer_of(type, data);
   }
 
   double to_double() {
@@ -498,13 +674,40 @@ public:
     return this->as_double();
   }
 
-  double &as_double() {
+  double as_double() {
     if (static_cast<uint8_t>(type) < CELL_TYPE_MIN_FLOAT ||
         static_cast<uint8_t>(type) > CELL_TYPE_MAX_FLOAT) {
-      throw cell_access_exception_c(
-          "Cell is not a floating point: " + this->to_string(), this->locator);
+      throw cell_access_exception_c("Cell is not a floating point: " +
+                                        this->to_string(),
+                                    this->get_location());
+    }
+    return double_of(type, data);
+  }
+
+  //! \brief Read integer data as stored for a given type
+  //! \note  Narrower types only set their own member of the data
+  static int64_t integer_of(cell_type_e type, const data_u &data) {
+    switch (type) {
+    case cell_type_e::U8:
+      return data.u8;
+    case cell_type_e::U16:
+      return data.u16;
+    case cell_type_e::U32:
+      return data.u32;
+    case cell_type_e::I8:
+      return data.i8;
+    case cell_type_e::I16:
+      return data.i16;
+    case cell_type_e::I32:
+      return data.i32;
+    default:
+      return data.i64;
     }
-    return data.f64;
+  }
+
+  //! \brief Read floating point data as stored for a given type
+  static double double_of(cell_type_e type, const data_u &data) {
+    return type == cell_type_e::F32 ? data.f32 : data.f64;
   }
 
   std::string as_string() {
@@ -514,49 +717,44 @@ public:
       return this->data.cstr;
     }
     if (this->type == cell_type_e::SYMBOL) {
-      return this->data.sym->value;
+      return symbols::name_of(this->data.sym.id);
     }
-    throw cell_access_exception_c("Cell is not a string", this->locator);
+    throw cell_access_exception_c("Cell is not a string", this->get_location());
   }
 
+  //! \note  The string may be shared, so it must not be written to
   char *as_c_string() {
     if (this->type != cell_type_e::STRING) {
       throw cell_access_exception_c("Cell does not contain a string",
-                                    this->locator);
+                                    this->get_location());
     }
     return this->data.cstr;
   }
 
-  std::string as_symbol() {
-    if (this->type != cell_type_e::SYMBOL) {
-      throw cell_access_exception_c(std::string("Cell is not a symbol: ") +
-                                        cell_type_to_string(this->type) + " " +
-                                        this->to_string(true, true),
-                                    this->locator);
-    }
-    if (!this->data.sym)
-      return "";
-    return this->data.sym->value;
+  std::string as_symbol() { return as_symbol_ref(); }
+
+  const std::string &as_symbol_ref() {
+    return symbols::name_of(as_symbol_id());
   }
 
-  std::string &as_symbol_ref() {
+  symbol_id_t as_symbol_id() {
     if (this->type != cell_type_e::SYMBOL) {
       throw cell_access_exception_c(std::string("Cell is not a symbol: ") +
                                         cell_type_to_string(this->type) + " " +
                                         this->to_string(true, true),
-                                    this->locator);
-    }
-    if (!this->data.sym) {
-      this->data.sym = new symbol_s();
+                                    this->get_location());
     }
-    return this->data.sym->value;
+    return this->data.sym.id;
   }
 
   cell_list_t to_list() { return this->as_list(); }
 
+  //! \brief Get the list of the cell to modify, or to hand out its cells
+  //! \note  Once its cells may be reached from elsewhere the list no
+  //!        longer owns them, so copies of the cell no longer share it
   cell_list_t &as_list() {
     if (type != cell_type_e::LIST) {
-      throw cell_access_exception_c("Cell is not a list", this->locator);
+      throw cell_access_exception_c("Cell is not a list", this->get_location());
     }
     return as_list_info().list;
   }
@@ -564,23 +762,49 @@ public:
   list_info_s to_list_info() { return this->as_list_info(); }
 
   list_info_s &as_list_info() {
+    auto &list_info = own_list_info();
+    if (list_info.owned) {
+      list_info.owned = false;
+    }
+    return list_info;
+  }
+
+  //! \brief Get the list of the cell to modify by adding copies to it or
+  //!        dropping cells from it, without handing out any of its cells
+  list_info_s &own_list_info() {
     if (type != cell_type_e::LIST) {
-      throw cell_access_exception_c("Cell is not a list", this->locator);
+      throw cell_access_exception_c("Cell is not a list", this->get_location());
+    }
+    if (data.list->shares) {
+      unshare();
     }
     return *data.list;
   }
 
+  //! \brief Get the list of the cell to read
+  //! \note  The list may be shared, so it must not be modified, or held
+  //!        while anything is evaluated
+  const list_info_s &read_list_info() {
+    if (type != cell_type_e::LIST) {
+      throw cell_access_exception_c("Cell is not a list", this->get_location());
+    }
+    return *data.list;
+  }
+
+  const cell_list_t &read_list() { return read_list_info().list; }
+
   aberrant_cell_if *as_aberrant() const {
     if (type != cell_type_e::ABERRANT) {
       throw cell_access_exception_c("Cell is not an aberrant cell",
-                                    this->locator);
+                                    this->get_location());
     }
     return data.aberrant;
   }
 
   function_info_s &as_function_info() {
     if (this->type != cell_type_e::FUNCTION) {
-      throw cell_access_exception_c("Cell is not a function", this->locator);
+      throw cell_access_exception_c("Cell is not a function",
+                                    this->get_location());
     }
     return *(this->data.fn);
   }
@@ -588,7 +812,7 @@ public:
   environment_info_s &as_environment_info() {
     if (this->type != cell_type_e::ENVIRONMENT) {
       throw cell_access_exception_c("Cell is not an environment",
-                                    this->locator);
+                                    this->get_location());
     }
     return *(this->data.env);
   }
@@ -596,42 +820,58 @@ public:
   void *as_pointer() const {
     if (type != cell_type_e::PTR) {
       throw cell_access_exception_c("Cell does not contain a pointer",
-                                    this->locator);
+                                    this->get_location());
     }
     return data.ptr;
   }
 
+  //! \brief Get the dict of the cell to modify, or to hand out its cells
+  //! \note  As with as_list
   cell_dict_t &as_dict() {
+    auto &dict = own_dict();
+    this->data.dict->owned = false;
+    return dict;
+  }
+
+  //! \brief Get the dict of the cell to modify by dropping cells from it,
+  //!        without handing out any of its cells
+  cell_dict_t &own_dict() {
     if (this->type != cell_type_e::DICT) {
-      throw cell_access_exception_c("Cell is not a dict", this->locator);
+      throw cell_access_exception_c("Cell is not a dict", this->get_location());
+    }
+    if (this->data.dict->shares) {
+      unshare();
     }
     return this->data.dict->data;
   }
 
-  void update_string(const std::string data) {
-    if (this->type != cell_type_e::STRING) {
-      throw cell_access_exception_c("Cell does not contain a string to update",
-                                    this->locator);
-    }
-    if (this->data.cstr) {
-      delete[] this->data.cstr;
+  //! \brief Get the dict of the cell to read
+  //! \note  As with read_list_info
+  const cell_dict_t &read_dict() {
+    if (this->type != cell_type_e::DICT) {
+      throw cell_access_exception_c("Cell is not a dict", this->get_location());
     }
-
-    this->data.cstr = new char[data.size() + 1];
-    strncpy(this->data.cstr, data.data(), data.size());
-    this->data.cstr[data.size()] = '\0';
+    return this->data.dict->data;
   }
 
+  //! \brief Update the string the cell holds
+  //! \note  Strings are allocated with a count of the other cells sharing
+  //!        them ahead of their characters, so that copies of them can
+  //!        share them. Those allocated elsewhere, by modules, are copied
+  //!        the first time that they are
+  void update_string(const std::string &data);
+
   char as_char() const {
     if (this->type != cell_type_e::CHAR) {
-      throw cell_access_exception_c("Cell is not a char", this->locator);
+      throw cell_access_exception_c("Cell is not a char", this->get_location());
     }
     return this->data.ch;
   }
 
   cell_ptr get_alias() const {
     if (this->type != cell_type_e::ALIAS) {
-      throw cell_access_exception_c("Cell is not an alias", this->locator);
+      throw cell_access_exception_c("Cell is not an alias",
+                                    this->get_location());
     }
     return this->data.alias->cell;
   }
@@ -653,16 +893,94 @@ public:
     return static_cast<uint8_t>(type) >= CELL_TYPE_MIN_NUMERIC &&
            static_cast<uint8_t>(type) <= CELL_TYPE_MAX_NUMERIC;
   }
+
+  //! \brief Check if a cell is one of the shared constant cells
+  //! \note  Constant cells must never be updated in place
+  inline bool is_constant() const { return is_immortal(); }
+
+private:
+  // Perform any cleanup of this cell required before updating to new data
+  void release_for_update(cell_type_e other_type) {
+    if (this->type == cell_type_e::ENVIRONMENT ||
+        this->type == cell_type_e::ABERRANT ||
+        other_type == cell_type_e::ENVIRONMENT ||
+        other_type == cell_type_e::ABERRANT) {
+      throw cell_access_exception_c("Reallocating to/from a Nibi envrionment "
+                                    "or aberrant cell is an illegal operation",
+                                    this->get_location());
+    }
+
+    if (this->type == cell_type_e::SYMBOL) {
+      release_site();
+    }
+
+    if (this->type == cell_type_e::STRING) {
+      release_string();
+    }
+
+    if (this->type == cell_type_e::FUNCTION && this->data.fn &&
+        !(flags & SHARED_FN)) {
+      delete this->data.fn;
+    }
+    flags &= ~SHARED_FN;
+
+    if (this->type == cell_type_e::LIST && this->data.list) {
+      release_shared(this->data.list);
+    }
+
+    if (this->type == cell_type_e::DICT && this->data.dict) {
+      release_shared(this->data.dict);
+    }
+  }
+
+  // Drop the cell's hold on a list or dict, which is freed once no
+  // cell shares it
+  template <typename T> static void release_shared(T *data) {
+    if (data->shares) {
+      data->shares--;
+      return;
+    }
+    delete data;
+  }
+
+  // Give the cell a list or dict of its own in place of the one it
+  // shares, from copies of the cells they hold
+  void unshare();
+
+  // Hold the string held by another cell
+  void share_string(cell_c &other);
+
+  // Drop the cell's hold on its string
+  void release_string();
+
+  // Give up the cache a symbol cell was read through
+  void release_site();
 };
 
-#pragma pack(pop)
+static_assert(sizeof(cell_c) == 16, "Cells are expected to be 16 bytes");
 
 //! \brief Allocate a cell
 //! \params Ctor arguments for cell
 //! \note This is used to centralize allocations of cells
 //!       so we can swap memory management models
-constexpr auto allocate_cell = [](auto... args) -> nibi::cell_ptr {
-  return new cell_c(args...);
+constexpr auto allocate_cell = [](auto &&...args) -> nibi::cell_ptr {
+  return new cell_c(std::forward<decltype(args)>(args)...);
 };
 
+//! \brief Get the shared nil cell
+//! \note  Shared constant cells are immortal and may be handed out as
+//!        results anywhere, so they must never be updated in place.
+//!        See writable_cell and env_c::writable
+extern cell_ptr constant_nil();
+
+//! \brief Get a shared cell for an integer, allocating a new
+//!        cell if the integer is outside of the shared range
+//! \note  This is also used for booleans, which are 0 or 1
+extern cell_ptr constant_integer(int64_t value);
+
+//! \brief Get a cell that can be stored where it may be updated in place
+//! \param cell The cell to store
+//! \return The cell, or a copy of it if it is a shared constant
+extern cell_ptr writable_cell(const cell_ptr &cell);
+
 } // namespace nibi
@@ -0,0 +1,258 @@
+#include "libnibi/collector.hpp"
+#include "libnibi/cell.hpp"
+#include "libnibi/environment.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nibi {
+namespace collector {
+
+namespace detail {
+bool due{false};
+} // namespace detail
+
+namespace {
+// The least growth in tracked containers that triggers a collection,
+// so that programs that never hold many are rarely walked at all
+static constexpr std::size_t MIN_GROWTH = 10000;
+
+// Everything here is constant initialized, as containers
+// may be created while other statics are constructed
+tracked_c *first_tracked{nullptr};
+std::size_t num_tracked{0};
+std::size_t collect_at{MIN_GROWTH};
+stats_s stats;
+} // namespace
+
+tracked_c::tracked_c(kind_e kind) : next_(first_tracked), kind_(kind) {
+  if (first_tracked) {
+    first_tracked->prev_ = this;
+  }
+  first_tracked = this;
+  if (++num_tracked >= collect_at) {
+    detail::due = true;
+  }
+}
+
+tracked_c::~tracked_c() {
+  if (prev_) {
+    prev_->next_ = next_;
+  } else {
+    first_tracked = next_;
+  }
+  if (next_) {
+    next_->prev_ = prev_;
+  }
+  num_tracked--;
+}
+
+// A single collection. Each container has its holders accounted for
+// once every reference to them is found in a tracked container, and
+// any container that has some left unaccounted for is held from
+// elsewhere. The scratch of each is left cleared for the next one.
+//
+// Dict functions own the environment holding their data, so they are
+// walked through as if they were containers themselves, though only
+// those held by a tracked container are seen at all
+struct walk_s {
+  std::unordered_map<cell_c *, int64_t> functions_unaccounted;
+  std::vector<cell_c *> functions;
+  std::unordered_set<env_c *> function_envs;
+  std::unordered_set<cell_c *> reached_functions;
+  std::vector<tracked_c *> containers_to_walk;
+  std::vector<cell_c *> functions_to_walk;
+
+  static tracked_c *container_of(cell_c *cell) {
+    if (cell->type == cell_type_e::LIST && cell->data.list) {
+      return cell->data.list;
+    }
+    if (cell->type == cell_type_e::DICT && cell->data.dict) {
+      return cell->data.dict;
+    }
+    return nullptr;
+  }
+
+  static env_c *function_env_of(cell_c *cell) {
+    if (cell->type != cell_type_e::FUNCTION ||
+        (cell->flags & cell_c::SHARED_FN) || !cell->data.fn ||
+        cell->data.fn->type != function_type_e::FAUX) {
+      return nullptr;
+    }
+    return cell->data.fn->operating_env;
+  }
+
+  // The number of cells holding a container
+  static int64_t holders_of(tracked_c *container) {
+    if (container->kind_ == tracked_c::kind_e::LIST) {
+      return static_cast<list_info_s *>(container)->shares + 1;
+    }
+    return static_cast<dict_info_s *>(container)->shares + 1;
+  }
+
+  template <typename F> static void for_each_held(tracked_c *container, F fn) {
+    if (container->kind_ == tracked_c::kind_e::LIST) {
+      for (auto &cell : static_cast<list_info_s *>(container)->list) {
+        if (cell) {
+          fn(cell.get());
+        }
+      }
+      return;
+    }
+    for (auto &[key, cell] : static_cast<dict_info_s *>(container)->data) {
+      if (cell) {
+        fn(cell.get());
+      }
+    }
+  }
+
+  template <typename F> static void for_each_held(cell_c *function, F fn) {
+    function_env_of(function)->for_each([&](symbol_id_t, cell_ptr &cell) {
+      if (cell) {
+        fn(cell.get());
+      }
+    });
+  }
+
+  void count(cell_c *cell) {
+    if (auto *container = container_of(cell)) {
+      // A holder stands in for its references the first time it is
+      // seen, and each reference found accounts for one of them
+      if (!(cell->flags & cell_c::COLLECTING)) {
+        cell->flags |= cell_c::COLLECTING;
+        container->unaccounted_ += cell->refCount() - 1;
+      }
+      container->unaccounted_--;
+      return;
+    }
+    if (auto *env = function_env_of(cell)) {
+      auto [it, first] =
+          functions_unaccounted.try_emplace(cell, cell->refCount());
+      it->second--;
+      // Environments are walked once, even if shared by functions
+      if (first && function_envs.insert(env).second) {
+        functions.push_back(cell);
+      }
+    }
+  }
+
+  static void uncount(cell_c *cell) { cell->flags &= ~cell_c::COLLECTING; }
+
+  void reach(cell_c *cell) {
+    uncount(cell);
+    if (auto *container = container_of(cell)) {
+      if (!container->reachable_) {
+        container->reachable_ = true;
+        containers_to_walk.push_back(container);
+      }
+      return;
+    }
+    if (function_env_of(cell) && reached_functions.insert(cell).second) {
+      functions_to_walk.push_back(cell);
+    }
+  }
+
+  std::size_t run() {
+    auto count_cell = [this](cell_c *cell) { count(cell); };
+    auto reach_cell = [this](cell_c *cell) { reach(cell); };
+
+    // Account for the references that tracked containers hold
+    for (auto *container = first_tracked; container;
+         container = container->next_) {
+      for_each_held(container, count_cell);
+    }
+    for (std::size_t i = 0; i < functions.size(); i++) {
+      for_each_held(functions[i], count_cell);
+    }
+
+    // Anything held from elsewhere is in use, as is all that it reaches
+    for (auto *container = first_tracked; container;
+         container = container->next_) {
+      if (holders_of(container) + container->unaccounted_) {
+        container->reachable_ = true;
+        containers_to_walk.push_back(container);
+      }
+      container->unaccounted_ = 0;
+    }
+    for (auto &[function, unaccounted] : functions_unaccounted) {
+      if (unaccounted) {
+        reached_functions.insert(function);
+        functions_to_walk.push_back(function);
+      }
+    }
+    while (!containers_to_walk.empty() || !functions_to_walk.empty()) {
+      if (!containers_to_walk.empty()) {
+        auto *container = containers_to_walk.back();
+        containers_to_walk.pop_back();
+        for_each_held(container, reach_cell);
+        continue;
+      }
+      auto *function = functions_to_walk.back();
+      functions_to_walk.pop_back();
+      for_each_held(function, reach_cell);
+    }
+
+    // The items of the rest are taken out of them all before any is
+    // dropped, as dropping them frees the containers along with them
+    for (auto *function : functions) {
+      if (!reached_functions.contains(function)) {
+        for_each_held(function, uncount);
+      }
+    }
+    std::vector<cell_list_t> lists;
+    std::vector<cell_dict_t> dicts;
+    for (auto *container = first_tracked; container;
+         container = container->next_) {
+      if (container->reachable_) {
+        container->reachable_ = false;
+        continue;
+      }
+      for_each_held(container, uncount);
+      if (container->kind_ == tracked_c::kind_e::LIST) {
+        auto &list = static_cast<list_info_s *>(container)->list;
+        stats.collected_bytes +=
+            sizeof(list_info_s) + list.capacity() * sizeof(cell_ptr);
+        lists.push_back(std::move(list));
+        list.clear();
+      } else {
+        auto &dict = static_cast<dict_info_s *>(container)->data;
+        stats.collected_bytes +=
+            sizeof(dict_info_s) + dict.bucket_count() * sizeof(void *) +
+            dict.size() * (sizeof(cell_dict_t::value_type) + sizeof(void *));
+        dicts.push_back(std::move(dict));
+        dict.clear();
+      }
+    }
+
+    auto found = lists.size() + dicts.size();
+    lists.clear();
+    dicts.clear();
+    return found;
+  }
+};
+
+std::size_t collect() {
+  auto start = std::chrono::steady_clock::now();
+
+  auto found = walk_s().run();
+
+  collect_at = num_tracked + std::max(MIN_GROWTH, num_tracked);
+  detail::due = false;
+
+  auto pause = std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+  stats.collections++;
+  stats.collected += found;
+  stats.pause_us += pause;
+  stats.max_pause_us = std::max<uint64_t>(stats.max_pause_us, pause);
+  return found;
+}
+
+const stats_s &get_stats() { return stats; }
+
+} // namespace collector
+} // namespace nibi
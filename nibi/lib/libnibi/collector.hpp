@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Cells are freed by their reference counts, which can never fall to
+    zero for cells that hold one another. A dict given itself as a value
+    holds its own function, whose environment holds the dict's data.
+
+    Lists and dicts are tracked from the moment they are created so that
+    such cycles can be found by trial deletion. References held between
+    tracked containers are counted, and any container held from
+    somewhere else (an environment, the stack, an instruction) is kept
+    along with all it reaches. Whatever is left is only held by itself,
+    and is emptied so that the reference counts free it.
+
+    Collections are run once the number of tracked containers has
+    doubled since the last one left them, and only at the start of a
+    call, where everything in use is held by a reference.
+*/
+
+namespace nibi {
+namespace collector {
+
+//! \brief Counters kept by the collector
+struct stats_s {
+  uint64_t collections{0};
+  uint64_t collected{0};       // Containers found to be held only by cycles
+  uint64_t collected_bytes{0}; // By those and the storage of their items
+  uint64_t pause_us{0};        // Spent in all collections
+  uint64_t max_pause_us{0};    // Spent in the longest collection
+};
+
+//! \brief Something that cells can hold in cycles, see cell.hpp
+//! \note  Tracked objects are linked together, which is not synchronized.
+//!        As with the reference counts of cells, they must not be
+//!        created or destroyed on more than one thread at a time
+class tracked_c {
+public:
+  //! \brief What a tracked object is, so it can be walked
+  enum class kind_e : uint8_t { LIST, DICT };
+
+  //! \brief Track an object
+  explicit tracked_c(kind_e kind);
+
+  ~tracked_c();
+
+  // Copies are tracked on their own, and keep their place when assigned
+  tracked_c(const tracked_c &other) : tracked_c(other.kind_) {}
+  tracked_c &operator=(const tracked_c &) { return *this; }
+
+private:
+  friend struct walk_s;
+
+  tracked_c *prev_{nullptr};
+  tracked_c *next_{nullptr};
+  kind_e kind_;
+  // Scratch for a collection, see walk_s
+  bool reachable_{false};
+  int64_t unaccounted_{0};
+};
+
+namespace detail {
+extern bool due;
+} // namespace detail
+
+//! \brief Check if enough has been tracked since the last collection
+//!        that another should be run
+inline bool is_due() { return detail::due; }
+
+//! \brief Free the tracked containers that are only held by cycles
+//! \return The number of containers found
+//! \note  Must only be run where nothing in use is held without a
+//!        reference, as anything that looks unreferenced is freed
+extern std::size_t collect();
+
+//! \brief Get the counters kept by the collector
+extern const stats_s &get_stats();
+
+} // namespace collector
+} // namespace nibi
@@ -9,11 +9,20 @@ static constexpr const char *NIBI_MODULE_FILE_NAME = "mod.nibi";
 static constexpr const char *NIBI_MODULE_TEST_DIR = "tests";
 static constexpr const char *NIBI_APP_ENTRY_FILE_NAME = "main.nibi";
 static constexpr const char *NIBI_SYSTEM_CONFIG_FILE_NAME = "config.nibi";
+static constexpr const char *NIBI_AOT_SOURCE_SUFFIX = ".aot.cpp";
+static constexpr const char *NIBI_AOT_LIBRARY_SUFFIX = ".aot.lib";
 static constexpr uint32_t NIBI_MODULE_ABERRANT_ID_SIZE = 32;
 
 using ref_counter_underlying_type_t = std::uint32_t;
-using locator_line_underlying_type_t = std::uint16_t;
-using locator_column_underlying_type_t = std::uint8_t;
+
+//! \brief Bit widths of the fields packed into a source location,
+//!        which together must fill exactly one 64-bit word
+static constexpr uint32_t LOCATION_SOURCE_BITS = 16;
+static constexpr uint32_t LOCATION_LINE_BITS = 28;
+static constexpr uint32_t LOCATION_COLUMN_BITS = 20;
+static_assert(LOCATION_SOURCE_BITS + LOCATION_LINE_BITS +
+                  LOCATION_COLUMN_BITS ==
+              64);
 
 } // namespace config
 } // namespace nibi
@@ -1,67 +1,250 @@
 #include "libnibi/environment.hpp"
 
+#include <algorithm>
+
 namespace nibi {
-env_c::~env_c() {}
+// Everything here is constant initialized and never freed, as
+// environments and cells may be made and destroyed while other
+// statics are constructed and destroyed
+std::size_t env_c::binding_epoch_{1};
+uint32_t *env_c::locals_{nullptr};
+std::size_t env_c::num_locals_{0};
+std::vector<binding_cache_s> *env_c::sites_{nullptr};
+std::vector<uint32_t> *env_c::free_sites_{nullptr};
+env_c::cache_stats_s env_c::cache_stats_;
+
+env_c::~env_c() { unbind_all(); }
+
+env_c::env_c(const env_c &other)
+    : parent_env_(other.parent_env_), cell_map_(other.cell_map_),
+      slot_symbols_(other.slot_symbols_), slots_(other.slots_),
+      loaded_modules_(other.loaded_modules_) {
+  for (auto &[id, cell] : cell_map_) {
+    bound(id);
+  }
+}
+
+env_c &env_c::operator=(const env_c &other) {
+  if (&other == this) {
+    return *this;
+  }
+  unbind_all();
+  parent_env_ = other.parent_env_;
+  cached_ = false;
+  cell_map_ = other.cell_map_;
+  slot_symbols_ = other.slot_symbols_;
+  slots_ = other.slots_;
+  loaded_modules_ = other.loaded_modules_;
+  for (auto &[id, cell] : cell_map_) {
+    bound(id);
+  }
+  return *this;
+}
 
 env_c::env_c(env_c *parent_env) : parent_env_(parent_env) {}
 
-env_c *env_c::get_env(const std::string &name) {
+env_c::env_c(env_c *parent_env, const std::vector<symbol_id_t> &slot_symbols)
+    : parent_env_(parent_env), slot_symbols_(&slot_symbols),
+      slots_(slot_symbols.size()) {}
 
-  if (cell_map_.find(name) != cell_map_.end()) {
+env_c *env_c::get_env(symbol_id_t id) {
+
+  if (auto slot = find_slot(id); slot && slots_[*slot]) {
+    return this;
+  }
+
+  if (cell_map_.find(id) != cell_map_.end()) {
     return this;
   }
 
   if (parent_env_) {
-    return parent_env_->get_env(name);
+    return parent_env_->get_env(id);
   }
 
   return nullptr;
 }
 
-cell_ptr env_c::get(const std::string &name) {
-  auto it = cell_map_.find(name);
+cell_ptr env_c::get(symbol_id_t id) {
+  if (auto slot = find_slot(id); slot && slots_[*slot]) {
+    return slots_[*slot];
+  }
+
+  auto it = cell_map_.find(id);
   if (it != cell_map_.end()) {
     return it->second;
   }
 
   if (parent_env_) {
-    return parent_env_->get(name);
+    return parent_env_->get(id);
   }
 
   return nullptr;
 }
 
-bool env_c::do_set(const std::string &name, const cell_ptr &cell) {
+cell_ptr env_c::resolve(symbol_id_t id, binding_cache_s &cache) {
+  // A slot left unbound may be bound at any time, shadowing whatever
+  // is found past it without anything else changing
+  bool may_be_shadowed{false};
+  for (auto *env = this; env; env = env->parent_env_) {
+    if (auto slot = env->find_slot(id)) {
+      if (env->slots_[*slot]) {
+        return env->slots_[*slot];
+      }
+      may_be_shadowed = true;
+    }
+
+    auto it = env->cell_map_.find(id);
+    if (it == env->cell_map_.end()) {
+      continue;
+    }
+
+    // Anything shadowing a root binding must be bound in a map while
+    // it is cached, so only those are stable between changes of the
+    // epoch. Sites in frames of another shape may have slots for it
+    if (!env->parent_env_ && !may_be_shadowed && !is_bound_locally(id)) {
+      env->cached_ = true;
+      cache.binding = &it->second;
+      cache.epoch = binding_epoch_;
+      cache.shape = get_shape();
+    }
+    return it->second;
+  }
+  return nullptr;
+}
+
+void env_c::bound(symbol_id_t id) {
+  if (!parent_env_) {
+    if (cached_) {
+      binding_epoch_++;
+    }
+    return;
+  }
+  if (id >= num_locals_) {
+    auto num_locals = std::max<std::size_t>(id + 1, num_locals_ * 2);
+    auto *locals = new uint32_t[num_locals]();
+    std::copy(locals_, locals_ + num_locals_, locals);
+    delete[] locals_;
+    locals_ = locals;
+    num_locals_ = num_locals;
+  }
+  locals_[id]++;
+}
+
+void env_c::unbound(symbol_id_t id) {
+  if (!parent_env_) {
+    if (cached_) {
+      binding_epoch_++;
+    }
+    return;
+  }
+  locals_[id]--;
+}
+
+void env_c::unbind_all() {
+  if (!parent_env_) {
+    if (cached_ && !cell_map_.empty()) {
+      binding_epoch_++;
+    }
+    return;
+  }
+  for (auto &[id, cell] : cell_map_) {
+    locals_[id]--;
+  }
+}
+
+uint32_t env_c::acquire_site() {
+  if (!sites_) {
+    sites_ = new std::vector<binding_cache_s>(1);
+    free_sites_ = new std::vector<uint32_t>();
+  }
+  if (!free_sites_->empty()) {
+    auto site = free_sites_->back();
+    free_sites_->pop_back();
+    return site;
+  }
+  sites_->emplace_back();
+  return static_cast<uint32_t>(sites_->size() - 1);
+}
 
-  auto it = cell_map_.find(name);
+void env_c::release_site(uint32_t site) {
+  (*sites_)[site] = {};
+  free_sites_->push_back(site);
+}
+
+bool env_c::do_set(symbol_id_t id, const cell_ptr &cell) {
+
+  if (auto slot = find_slot(id); slot && slots_[*slot]) {
+    slots_[*slot] = cell;
+    return true;
+  }
+
+  auto it = cell_map_.find(id);
   if (it != cell_map_.end()) {
     it->second = cell;
     return true;
   }
 
   if (parent_env_) {
-    return parent_env_->do_set(name, cell);
+    return parent_env_->do_set(id, cell);
   }
 
   return false;
 }
 
-void env_c::set(const std::string &name, const cell_ptr &cell) {
-  if (!do_set(name, cell)) {
-    cell_map_[name] = cell;
+void env_c::set(symbol_id_t id, const cell_ptr &cell) {
+  if (do_set(id, cell)) {
+    return;
+  }
+
+  // Symbols that were resolved to a slot are bound
+  // there rather than in the map
+  if (auto slot = find_slot(id)) {
+    slots_[*slot] = cell;
+    return;
+  }
+  cell_map_[id] = cell;
+  bound(id);
+}
+
+void env_c::define(symbol_id_t id, const cell_ptr &cell) {
+  if (auto slot = find_slot(id)) {
+    slots_[*slot] = cell;
+    return;
+  }
+
+  auto [it, inserted] = cell_map_.insert_or_assign(id, cell);
+  if (inserted) {
+    bound(id);
   }
 }
 
-bool env_c::drop(const std::string &name) {
+cell_ptr env_c::writable(const cell_ptr &target, const cell_ptr &expression) {
+  if (!target->is_constant()) {
+    return target;
+  }
+  auto copy = writable_cell(target);
+  if (expression->type == cell_type_e::SYMBOL) {
+    set(expression->as_symbol_id(), copy);
+  }
+  return copy;
+}
+
+bool env_c::drop(symbol_id_t id) {
+
+  if (auto slot = find_slot(id); slot && slots_[*slot]) {
+    slots_[*slot] = nullptr;
+    return true;
+  }
 
-  auto it = cell_map_.find(name);
+  auto it = cell_map_.find(id);
   if (it != cell_map_.end()) {
     cell_map_.erase(it);
+    unbound(id);
     return true;
   }
 
   if (parent_env_) {
-    return parent_env_->drop(name);
+    return parent_env_->drop(id);
   }
 
   return false;
@@ -2,8 +2,10 @@
 
 #include "cell.hpp"
 
+#include <optional>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <map>
 
@@ -11,6 +13,8 @@ namespace nibi {
 
 //! \brief The environment object that will be used to store
 //!        and manage the cells that are used in different scopes
+//! \note  Cells are keyed by interned symbol id. Overloads taking
+//!        a name are provided for convenience
 class env_c {
 public:
   // The current implementation has been perfomance tested
@@ -23,74 +27,274 @@ public:
   // followed by phmap::parallel_node_hash_map
   // and then std::unordered_map
   //
-  using env_map_t = std::map<std::string, cell_ptr>;
+  using env_map_t = std::map<symbol_id_t, cell_ptr>;
 
   env_c() = default;
   ~env_c();
 
+  // Copies account for the bindings they hold, see locals_
+  env_c(const env_c &other);
+  env_c &operator=(const env_c &other);
+
   //! \brief Create an environment object without parameters
   //! \param parent_env The parent environment to use for searching
   //!        upper level scopes
   env_c(env_c *parent_env);
 
+  //! \brief Create an environment object with a frame of slots
+  //! \param parent_env The parent environment to use for searching
+  //!        upper level scopes
+  //! \param slot_symbols The symbols resolved to slots of this environment.
+  //!        They must outlive the environment
+  //! \note  Slots hold the cells of names that are known ahead of time
+  //!        (function parameters and locals) so that they can be bound
+  //!        and accessed by index rather than through the map
+  env_c(env_c *parent_env, const std::vector<symbol_id_t> &slot_symbols);
+
   //! \brief Get the env that a cell is in
-  //! \param name The name of the cell
+  //! \param id The symbol of the cell
   //! \return The env if it exists in this environment or
   //!         a parent environment. otherwise, nullptr
-  env_c *get_env(const std::string &name);
+  env_c *get_env(symbol_id_t id);
+
+  env_c *get_env(const std::string &name) {
+    auto id = symbols::find(name);
+    return id ? get_env(*id) : nullptr;
+  }
 
   //! \brief Get a cell from the environment
-  //! \param name The name of the cell
+  //! \param id The symbol of the cell
   //! \return The cell if it exists in this environment or
   //!         a parent environment. otherwise, nullptr
   //! \note Use this function to get a cell from the environment
   //!       that needs to be updated if we want to ensure it exists
   //!       in the environment or in the parent
-  cell_ptr get(const std::string &name);
+  cell_ptr get(symbol_id_t id);
+
+  cell_ptr get(const std::string &name) {
+    auto id = symbols::find(name);
+    return id ? get(*id) : nullptr;
+  }
+
+  //! \brief Get a cell from the environment through an inline cache
+  //! \param id The symbol of the cell
+  //! \param cache The cache of the site that is referencing the symbol
+  //! \return The cell if it exists in this environment or
+  //!         a parent environment. otherwise, nullptr
+  //! \note Only bindings held by a root environment are cached, and
+  //!       only for sites where no slot could come to shadow them. The
+  //!       cache refers to the binding itself so rebinding the symbol
+  //!       is seen through it. Creating or dropping a binding in a root
+  //!       that caches refer to moves the epoch on, while any binding
+  //!       of the symbol in another environment's map keeps caches of
+  //!       it from being used for as long as it is held
+  cell_ptr get(symbol_id_t id, binding_cache_s &cache) {
+    if (cache.epoch == binding_epoch_ && !is_bound_locally(id) &&
+        cache.shape == get_shape()) {
+      cache_stats_.hits++;
+      return *cache.binding;
+    }
+    cache_stats_.misses++;
+    return resolve(id, cache);
+  }
+
+  //! \brief Get the cell a symbol cell refers to, through an inline
+  //!        cache kept for the cell
+  //! \param symbol The symbol cell
+  //! \return The cell if it exists in this environment or
+  //!         a parent environment. otherwise, nullptr
+  cell_ptr read(cell_c &symbol) {
+    auto &ref = symbol.data.sym;
+    if (!ref.site) {
+      ref.site = acquire_site();
+    }
+    return get(ref.id, (*sites_)[ref.site]);
+  }
+
+  //! \brief Counters kept by the inline caches
+  struct cache_stats_s {
+    uint64_t hits{0};
+    uint64_t misses{0};
+  };
+
+  //! \brief Get the counters kept by the inline caches
+  static const cache_stats_s &get_cache_stats() { return cache_stats_; }
+
+  //! \brief Give up the cache of a symbol cell, see read
+  static void release_site(uint32_t site);
 
   //! \brief Set a cell in the environment
-  //! \param name The name of the cell
+  //! \param id The symbol of the cell
   //! \param cell The cell to set
-  void set(const std::string &name, const cell_ptr &cell);
+  void set(symbol_id_t id, const cell_ptr &cell);
+
+  void set(const std::string &name, const cell_ptr &cell) {
+    set(symbols::intern(name), cell);
+  }
+
+  //! \brief Bind a cell in this environment, shadowing any binding
+  //!        of the same symbol in a parent environment
+  //! \param id The symbol of the cell
+  //! \param cell The cell to bind
+  void define(symbol_id_t id, const cell_ptr &cell);
+
+  //! \brief Get a cell that is about to be updated in place
+  //! \param target The cell to update
+  //! \param expression The expression that the target was resolved from
+  //! \return The target, or a copy of it if it is a shared constant.
+  //!         If the expression is a symbol it is rebound to the copy
+  //! \note  This keeps updates such as `set` from modifying a shared
+  //!        constant that every other holder of it would see
+  cell_ptr writable(const cell_ptr &target, const cell_ptr &expression);
 
   //! \brief Drop a cell from the environment, or parent environment(s)
-  //! \param name The name of the cell
+  //! \param id The symbol of the cell
   //! \returns True if the cell was dropped, false if item not found
   //! \post The cell will be erased from the environment and marked for deletion
-  bool drop(const std::string &name);
+  bool drop(symbol_id_t id);
 
-  //! \brief Get the map of cells in the environment
-  //! \return The map of cells in the environment
-  //! \note This is meant for quick cell creation and
-  //!       retrieval for specific environments
-  env_map_t &get_map() { return cell_map_; }
+  bool drop(const std::string &name) {
+    auto id = symbols::find(name);
+    return id ? drop(*id) : false;
+  }
+
+  //! \brief Check if this environment is another, or is within it
+  //! \param env The environment to look for
+  //! \return True iff env is this environment or one of its parents
+  bool is_within(const env_c *env) const {
+    for (auto *current = this; current; current = current->parent_env_) {
+      if (current == env) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  //! \brief Get the frame of the lambda call this environment is within
+  //! \return The nearest of this environment and its parents that holds
+  //!         slots, or nullptr outside of any call
+  env_c *get_frame() {
+    for (auto *current = this; current; current = current->parent_env_) {
+      if (current->slot_symbols_) {
+        return current;
+      }
+    }
+    return nullptr;
+  }
+
+  //! \brief Indicate that a lambda has been defined within this environment
+  //! \note  The frame it is within must then outlive the call that made it,
+  //!        so no call in tail position may take the frame's place
+  void capture() {
+    if (auto *frame = get_frame()) {
+      frame->captured_ = true;
+    }
+  }
+
+  //! \brief Check if a lambda has been defined within the frame
+  bool is_captured() const { return captured_; }
+
+  //! \brief Get the shape of the frame this environment is within
+  //! \return The symbols of its slots, or nullptr outside of any call
+  const std::vector<symbol_id_t> *get_shape() {
+    auto *frame = get_frame();
+    return frame ? frame->slot_symbols_ : nullptr;
+  }
+
+  //! \brief Call a function with each cell bound in this environment
+  //! \param fn The function, given the symbol and cell of each binding
+  //! \note  Bindings held by slots and parent environments are not visited
+  template <typename F> void for_each(F &&fn) {
+    for (auto &[id, cell] : cell_map_) {
+      fn(id, cell);
+    }
+  }
+
+  //! \brief Get a slot of the environment's frame
+  //! \param index The index of the slot
+  //! \return The cell held in the slot, nullptr if it is unbound
+  cell_ptr &get_slot(std::size_t index) { return slots_[index]; }
+
+  //! \brief Find the slot a symbol was resolved to
+  //! \param id The symbol to find
+  //! \return The index of the slot iff the symbol was resolved to one
+  std::optional<std::size_t> find_slot(symbol_id_t id) const {
+    // Searched from the back so that the last of any
+    // duplicated parameter names is the one that is found
+    for (std::size_t i = slots_.size(); i > 0; i--) {
+      if ((*slot_symbols_)[i - 1] == id) {
+        return i - 1;
+      }
+    }
+    return std::nullopt;
+  }
 
   //! \brief Indicate that a module has been loaded
   //! \param module_name The name of the module
   void indicate_loaded_module(const std::string &module_name) {
-    loaded_modules_.insert(module_name);
+    loaded_modules_.insert(symbols::intern(module_name));
   }
 
   //! \brief Check if a module has been loaded
   //! \param module_name The name of the module
   //! \return True if the module has been loaded, false otherwise
   bool is_module_loaded(const std::string &module_name) {
-    if (loaded_modules_.contains(module_name)) {
+    auto id = symbols::find(module_name);
+    return id && is_module_loaded(*id);
+  }
+
+private:
+  // Moved on whenever a binding is created or removed in a root that
+  // caches refer to, as either can change what a symbol resolves to
+  static std::size_t binding_epoch_;
+
+  // The number of bindings of each symbol held in the maps of
+  // environments other than roots. A cached binding of a root is
+  // only used while there are none that could shadow it
+  static uint32_t *locals_;
+  static std::size_t num_locals_;
+
+  // Caches of symbol cells, indexed by their site. The first is never
+  // handed out, so that cells without one hold 0
+  static std::vector<binding_cache_s> *sites_;
+  static std::vector<uint32_t> *free_sites_;
+
+  static cache_stats_s cache_stats_;
+
+  env_c *parent_env_{nullptr};
+  bool cached_{false};   // Caches refer to bindings of the environment
+  bool captured_{false}; // Lambdas were defined within the frame
+  env_map_t cell_map_;
+  const std::vector<symbol_id_t> *slot_symbols_{nullptr};
+  std::vector<cell_ptr> slots_;
+  std::set<symbol_id_t> loaded_modules_;
+
+  inline bool do_set(symbol_id_t id, const cell_ptr &cell);
+  cell_ptr resolve(symbol_id_t id, binding_cache_s &cache);
+
+  static bool is_bound_locally(symbol_id_t id) {
+    return id < num_locals_ && locals_[id];
+  }
+
+  // Account for a binding created in, or removed from, the map
+  void bound(symbol_id_t id);
+  void unbound(symbol_id_t id);
+
+  // Account for every binding of the map being removed at once
+  void unbind_all();
+
+  static uint32_t acquire_site();
+
+  bool is_module_loaded(symbol_id_t id) {
+    if (loaded_modules_.contains(id)) {
       return true;
     }
 
     if (parent_env_ != nullptr) {
-      return parent_env_->is_module_loaded(module_name);
+      return parent_env_->is_module_loaded(id);
     }
 
     return false;
   }
-
-private:
-  env_c *parent_env_{nullptr};
-  env_map_t cell_map_;
-  std::set<std::string> loaded_modules_;
-
-  inline bool do_set(const std::string &name, const cell_ptr &cell);
 };
 } // namespace nibi
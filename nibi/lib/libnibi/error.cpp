@@ -7,15 +7,13 @@ namespace nibi {
 
 void error_c::draw(bool markup) const {
 
-  if (!locator_ || !markup) {
+  if (!location_ || !markup) {
     std::cout << rang::fg::red << "ERROR: " << rang::fg::reset << message_
               << std::endl;
     return;
   }
 
-  if (locator_) {
-    draw_locator(*locator_);
-  }
+  draw_locator(*location_.materialize());
 
   std::cout << rang::fg::cyan << "\nMessage: " << rang::fg::reset << message_
             << "\n"
@@ -9,19 +9,20 @@ class error_c {
 public:
   //! \brief Create an error that doesn't contain a location.
   //! \param message The error message.
-  error_c(const std::string message) : locator_(nullptr), message_(message) {}
+  error_c(const std::string message) : message_(message) {}
 
   //! \brief Create an error.
-  //! \param locator The locator interface.
+  //! \param location The location of the error.
   //! \param message The error message.
-  error_c(locator_ptr locator, const std::string message)
-      : locator_(locator), message_(message) {}
+  error_c(location_s location, const std::string message)
+      : location_(location), message_(message) {}
 
-  //! \brief Check if the error has a locator interface.
-  bool has_locator() const { return locator_ != nullptr; }
+  //! \brief Check if the error has a location.
+  bool has_locator() const { return static_cast<bool>(location_); }
 
-  //! \brief Get the locator interface.
-  const locator_if *get_locator() const { return locator_.get(); }
+  //! \brief Get a locator interface for the location of the error.
+  //! \note  The locator is created on each call
+  locator_ptr get_locator() const { return location_.materialize(); }
 
   //! \brief Get the error message.
   const std::string get_message() const { return message_; }
@@ -31,7 +32,7 @@ public:
   void draw(bool markup = true) const;
 
 private:
-  locator_ptr locator_{nullptr};
+  location_s location_;
   std::string message_{""};
 };
 
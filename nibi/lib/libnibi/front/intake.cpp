@@ -11,7 +11,7 @@ namespace nibi {
 
 namespace {
 
-token_c generate_type_token(token_e token, locator_ptr locator) {
+token_c generate_type_token(token_e token, location_s locator) {
 
   switch (token) {
   case token_e::NIL:
@@ -90,7 +90,8 @@ static std::regex is_number("[+-]?([0-9]*[.])?[0-9]+");
 
 intake_c::intake_c(instruction_processor_if &proc, error_callback_f error_cb,
                    source_manager_c &sm, function_router_t &router)
-    : processor_(proc), error_cb_(error_cb), sm_(sm), symbol_router_(router) {
+    : processor_(proc), error_cb_(error_cb), sm_(sm), symbol_router_(router),
+      optimizer_(router), verifier_(router, error_cb) {
   parser_ = std::make_unique<parser_c>(symbol_router_, error_cb_);
 }
 
@@ -116,7 +117,7 @@ void intake_c::read_line(std::string_view line,
 
 void intake_c::evaluate(std::string_view data,
                         std::shared_ptr<source_origin_c> origin,
-                        locator_ptr location) {
+                        location_s location) {
   process_line(data, origin, location);
   check_for_complete_expression();
 }
@@ -125,7 +126,7 @@ void intake_c::end_of_file() { tracker_ = tracker_s(); }
 
 void intake_c::check_for_complete_expression() {
   if (tokens_.size()) {
-    error_cb_(error_c(tokens_.front().get_locator(), "Incomplete expression"));
+    error_cb_(error_c(tokens_.front().get_location(), "Incomplete expression"));
   }
 }
 
@@ -140,14 +141,14 @@ inline bool check_buffer(std::string &buffer, char c) {
 
 bool intake_c::process_line(std::string_view data,
                             std::shared_ptr<source_origin_c> origin,
-                            locator_ptr loc_override) {
+                            location_s loc_override) {
 
   for (std::size_t col = 0; col < data.size(); col++) {
     auto locator = (loc_override)
-                       ? origin->get_locator(
-                             tracker_.line_count + loc_override->get_line(),
-                             loc_override->get_column() + 1 + col)
-                       : origin->get_locator(tracker_.line_count, col);
+                       ? origin->get_location(
+                             tracker_.line_count + loc_override.get_line(),
+                             loc_override.get_column() + 1 + col)
+                       : origin->get_location(tracker_.line_count, col);
     if (std::isspace(data[col])) {
       continue;
     }
@@ -332,7 +333,10 @@ void intake_c::process_token(token_c token) {
   auto instruction = parser_->parse(tokens_);
 
   if (instruction && instruction->as_list().size()) {
-    processor_.instruction_ind(instruction);
+    optimizer_.optimize(instruction);
+    if (verifier_.verify(instruction)) {
+      processor_.instruction_ind(instruction);
+    }
   }
 
   tokens_.clear();
@@ -348,7 +352,7 @@ cell_ptr intake_c::parser_c::parse(std::vector<token_c> &tokens) {
   list = instruction_list();
 
   if (!list) {
-    error_cb_(error_c(tokens[0].get_locator(),
+    error_cb_(error_c(tokens[0].get_location(),
                       "Invalid instruction list - Expected '('"));
     return nullptr;
   }
@@ -399,7 +403,7 @@ cell_ptr intake_c::parser_c::instruction_list() {
   auto instruction =
       allocate_cell(list_info_s{list_types_e::INSTRUCTION, std::move(list)});
 
-  instruction->locator = instruction_start_locator;
+  instruction->set_location(instruction_start_locator);
   return std::move(instruction);
 }
 
@@ -424,7 +428,7 @@ cell_ptr intake_c::parser_c::access_list() {
 
   auto nlist =
       allocate_cell(list_info_s{list_types_e::ACCESS, std::move(list)});
-  nlist->locator = locator;
+  nlist->set_location(locator);
   return std::move(nlist);
 }
 
@@ -448,7 +452,7 @@ cell_ptr intake_c::parser_c::data_list() {
   next();
 
   auto nlist = allocate_cell(list_info_s{list_types_e::DATA, std::move(list)});
-  nlist->locator = locator;
+  nlist->set_location(locator);
   return std::move(nlist);
 }
 
@@ -527,15 +531,15 @@ cell_ptr intake_c::parser_c::symbol() {
 
   if (router_location == symbol_router_.end()) {
     auto cell = allocate_cell(symbol_s{symbol_raw});
-    cell->locator = current_location();
+    cell->set_location(current_location());
 
     next();
 
     return std::move(cell);
   }
 
-  auto cell = allocate_cell(router_location->second);
-  cell->locator = current_location();
+  auto cell = allocate_cell(shared_function_s{&router_location->second});
+  cell->set_location(current_location());
 
   next();
 
@@ -576,7 +580,7 @@ cell_ptr intake_c::parser_c::integer() {
   }
 
   auto cell = allocate_cell((int64_t)value_actual);
-  cell->locator = current_location();
+  cell->set_location(current_location());
 
   next();
 
@@ -590,7 +594,7 @@ cell_ptr intake_c::parser_c::boolean() {
   }
 
   auto cell = allocate_cell((int64_t)(current_token() == token_e::TRUE));
-  cell->locator = current_location();
+  cell->set_location(current_location());
 
   next();
 
@@ -616,7 +620,7 @@ cell_ptr intake_c::parser_c::real() {
   }
 
   auto cell = allocate_cell((double)value_actual);
-  cell->locator = current_location();
+  cell->set_location(current_location());
 
   next();
 
@@ -629,7 +633,7 @@ cell_ptr intake_c::parser_c::string() {
   }
 
   auto cell = allocate_cell(current_data());
-  cell->locator = current_location();
+  cell->set_location(current_location());
 
   next();
 
@@ -655,7 +659,7 @@ cell_ptr intake_c::parser_c::cchar() {
   }
 
   auto cell = allocate_cell((char)data_as_char);
-  cell->locator = current_location();
+  cell->set_location(current_location());
 
   next();
 
@@ -668,7 +672,7 @@ cell_ptr intake_c::parser_c::nil() {
   }
 
   auto cell = allocate_cell(cell_type_e::NIL);
-  cell->locator = current_location();
+  cell->set_location(current_location());
 
   next();
 
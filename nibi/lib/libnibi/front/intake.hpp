@@ -5,7 +5,9 @@
 #include "libnibi/interfaces/instruction_processor_if.hpp"
 #include "libnibi/source.hpp"
 #include "libnibi/types.hpp"
+#include "optimizer.hpp"
 #include "token.hpp"
+#include "verifier.hpp"
 #include <functional>
 #include <istream>
 #include <memory>
@@ -42,7 +44,7 @@ public:
   //! \param origin Source origin
   //! \param location Location of the line source
   void evaluate(std::string_view line, std::shared_ptr<source_origin_c> origin,
-                locator_ptr location);
+                location_s location);
 
   //! \brief Indicate the end of a file
   void end_of_file();
@@ -84,7 +86,7 @@ private:
       return (*tokens_)[index_].get_token();
     }
 
-    locator_ptr current_location() { return (*tokens_)[index_].get_locator(); }
+    location_s current_location() { return (*tokens_)[index_].get_location(); }
     std::string current_data() { return (*tokens_)[index_].get_data(); }
 
   private:
@@ -113,9 +115,9 @@ private:
   };
 
   struct tracker_s {
-    std::stack<locator_ptr> instruction_stack_;
-    std::stack<locator_ptr> data_stack_;
-    std::stack<locator_ptr> access_stack_;
+    std::stack<location_s> instruction_stack_;
+    std::stack<location_s> data_stack_;
+    std::stack<location_s> access_stack_;
     std::size_t line_count{0};
   };
 
@@ -126,12 +128,14 @@ private:
   function_router_t &symbol_router_;
   std::vector<token_c> tokens_;
   std::unique_ptr<parser_c> parser_;
+  optimizer_c optimizer_;
+  verifier_c verifier_;
 
   void check_for_complete_expression();
 
   bool process_line(std::string_view line,
                     std::shared_ptr<source_origin_c> origin,
-                    locator_ptr loc_override = nullptr);
+                    location_s loc_override = {});
 
   void process_token(token_c token);
 };
@@ -0,0 +1,303 @@
+#include "optimizer.hpp"
+
+#include "libnibi/interpreter/builtins/kernels.hpp"
+#include "libnibi/keywords.hpp"
+
+#include <string>
+#include <unordered_map>
+
+namespace nibi {
+
+namespace {
+
+enum class pure_e { ARITH, CMP, NOT, BITWISE };
+
+enum class bitwise_e : uint8_t { LSH, RSH, AND, OR, XOR, NOT };
+
+struct pure_s {
+  pure_e kind;
+  uint8_t op{0};
+};
+
+template <typename E> constexpr pure_s pure(pure_e kind, E op) {
+  return pure_s{kind, static_cast<uint8_t>(op)};
+}
+
+// Builtins that give the same value every time they are called with
+// the same numeric arguments, and do nothing else
+static std::unordered_map<std::string, pure_s> pure_builtins = {
+    {nibi::kw::ADD, pure(pure_e::ARITH, kernels::arith_e::ADD)},
+    {nibi::kw::SUB, pure(pure_e::ARITH, kernels::arith_e::SUB)},
+    {nibi::kw::MUL, pure(pure_e::ARITH, kernels::arith_e::MUL)},
+    {nibi::kw::DIV, pure(pure_e::ARITH, kernels::arith_e::DIV)},
+    {nibi::kw::MOD, pure(pure_e::ARITH, kernels::arith_e::MOD)},
+    {nibi::kw::POW, pure(pure_e::ARITH, kernels::arith_e::POW)},
+    {nibi::kw::EQ, pure(pure_e::CMP, kernels::cmp_e::EQ)},
+    {nibi::kw::NEQ, pure(pure_e::CMP, kernels::cmp_e::NEQ)},
+    {nibi::kw::LT, pure(pure_e::CMP, kernels::cmp_e::LT)},
+    {nibi::kw::GT, pure(pure_e::CMP, kernels::cmp_e::GT)},
+    {nibi::kw::LTE, pure(pure_e::CMP, kernels::cmp_e::LTE)},
+    {nibi::kw::GTE, pure(pure_e::CMP, kernels::cmp_e::GTE)},
+    {nibi::kw::AND, pure(pure_e::CMP, kernels::cmp_e::AND)},
+    {nibi::kw::OR, pure(pure_e::CMP, kernels::cmp_e::OR)},
+    {nibi::kw::NOT, pure_s{pure_e::NOT}},
+    {nibi::kw::BW_LSH, pure(pure_e::BITWISE, bitwise_e::LSH)},
+    {nibi::kw::BW_RSH, pure(pure_e::BITWISE, bitwise_e::RSH)},
+    {nibi::kw::BW_AND, pure(pure_e::BITWISE, bitwise_e::AND)},
+    {nibi::kw::BW_OR, pure(pure_e::BITWISE, bitwise_e::OR)},
+    {nibi::kw::BW_XOR, pure(pure_e::BITWISE, bitwise_e::XOR)},
+    {nibi::kw::BW_NOT, pure(pure_e::BITWISE, bitwise_e::NOT)}};
+
+inline bool is_name(function_info_s &fn, const char *name) {
+  return fn.name == name;
+}
+
+// Builtins that execute the data lists they are given as bodies. Any
+// other data list is a value, which keeps the instructions within it
+// as they were written
+inline bool takes_bodies(function_info_s &fn) {
+  return is_name(fn, kw::FN) || is_name(fn, kw::IF) ||
+         is_name(fn, kw::LOOP) || is_name(fn, kw::TRY) ||
+         is_name(fn, kw::DEFER);
+}
+
+// Builtins whose arguments are never evaluated as they were written
+inline bool takes_code(function_info_s &fn) {
+  return is_name(fn, kw::QUOTE) || is_name(fn, kw::MACRO);
+}
+
+// Builtins that bind or defer into the scope they're evaluated in
+inline bool uses_scope(function_info_s &fn) {
+  return is_name(fn, kw::ASSIGN) || is_name(fn, kw::FN) ||
+         is_name(fn, kw::MACRO) || is_name(fn, kw::ALIAS) ||
+         is_name(fn, kw::EVAL) || is_name(fn, kw::DEFER);
+}
+
+inline bool is_instruction(cell_ptr &cell) {
+  return cell->type == cell_type_e::LIST &&
+         cell->as_list_info().type == list_types_e::INSTRUCTION;
+}
+
+cell_ptr literal(cell_type_e type, const cell_c::data_u &data,
+                 location_s location) {
+  auto cell = allocate_cell(type);
+  cell->data = data;
+  cell->set_location(location);
+  return cell;
+}
+
+} // namespace
+
+void optimizer_c::optimize(cell_ptr &instruction) {
+  simplify(instruction, true);
+}
+
+function_info_s *optimizer_c::builtin_of(cell_ptr &cell) {
+  if (cell->type != cell_type_e::FUNCTION ||
+      !(cell->flags & cell_c::SHARED_FN)) {
+    return nullptr;
+  }
+  auto &fn = cell->as_function_info();
+  auto it = router_.find(fn.name);
+  if (it == router_.end() || &it->second != &fn) {
+    return nullptr;
+  }
+  return &fn;
+}
+
+void optimizer_c::simplify(cell_ptr &cell, bool top) {
+  if (!is_instruction(cell)) {
+    return;
+  }
+
+  auto &list = cell->as_list();
+  if (list.empty()) {
+    return;
+  }
+
+  auto *fn = builtin_of(list[0]);
+  if (fn && takes_code(*fn)) {
+    return;
+  }
+
+  for (auto &item : list) {
+    if (is_instruction(item)) {
+      simplify(item, false);
+    } else if (fn && takes_bodies(*fn) && item->type == cell_type_e::LIST &&
+               item->as_list_info().type == list_types_e::DATA) {
+      for (auto &body_item : item->as_list()) {
+        simplify(body_item, false);
+      }
+    }
+  }
+
+  if (!fn) {
+    return;
+  }
+
+  // The instruction given is kept an instruction
+  // so that it can still be processed as one
+  if (!top) {
+    if (auto folded = fold(cell, *fn)) {
+      cell = folded;
+      return;
+    }
+  }
+
+  if (is_name(*fn, kw::IF)) {
+    prune(cell, top);
+  }
+}
+
+cell_ptr optimizer_c::fold(cell_ptr &cell, function_info_s &fn) {
+  auto it = pure_builtins.find(fn.name);
+  if (it == pure_builtins.end()) {
+    return nullptr;
+  }
+
+  auto &list = cell->as_list();
+  for (auto i = list.begin() + 1; i != list.end(); ++i) {
+    if (!kernels::is_numeric((*i)->type)) {
+      return nullptr;
+    }
+  }
+
+  // Folding mirrors the builtins exactly, and anything they would
+  // raise an error for is left for them to raise when it is processed
+  auto &pure = it->second;
+  auto location = cell->get_location();
+  switch (pure.kind) {
+  case pure_e::ARITH: {
+    if (list.size() < 2) {
+      return nullptr;
+    }
+    auto op = static_cast<kernels::arith_e>(pure.op);
+    auto &first = list[1];
+    auto type = first->type;
+    auto data = first->data;
+    if (op == kernels::arith_e::SUB && list.size() == 2) {
+      type = kernels::result_type(op, first->type);
+      data.u64 = 0;
+      kernels::arithmetic(op, type, data, first->type, first->data);
+    }
+    for (auto i = list.begin() + 2; i != list.end(); ++i) {
+      if (kernels::arithmetic(op, type, data, (*i)->type, (*i)->data) !=
+          kernels::result_e::OK) {
+        return nullptr;
+      }
+    }
+    return literal(type, data, location);
+  }
+  case pure_e::CMP: {
+    if (list.size() != 3) {
+      return nullptr;
+    }
+    cell_c::data_u result{0};
+    result.i64 =
+        kernels::compare(static_cast<kernels::cmp_e>(pure.op), list[1]->type,
+                         list[1]->data, list[2]->type, list[2]->data);
+    return literal(cell_type_e::I64, result, location);
+  }
+  case pure_e::NOT: {
+    if (list.size() != 2) {
+      return nullptr;
+    }
+    cell_c::data_u result{0};
+    result.i64 = !list[1]->to_integer();
+    return literal(cell_type_e::I64, result, location);
+  }
+  case pure_e::BITWISE: {
+    auto op = static_cast<bitwise_e>(pure.op);
+    if (list.size() != (op == bitwise_e::NOT ? 2 : 3)) {
+      return nullptr;
+    }
+    auto lhs = list[1]->to_integer();
+    auto rhs = op == bitwise_e::NOT ? 0 : list[2]->to_integer();
+    cell_c::data_u result{0};
+    switch (op) {
+    case bitwise_e::LSH:
+    case bitwise_e::RSH:
+      // Shifts by more than the width of the value aren't defined
+      if (rhs < 0 || rhs >= 64) {
+        return nullptr;
+      }
+      result.i64 = op == bitwise_e::LSH ? lhs << rhs : lhs >> rhs;
+      break;
+    case bitwise_e::AND:
+      result.i64 = lhs & rhs;
+      break;
+    case bitwise_e::OR:
+      result.i64 = lhs | rhs;
+      break;
+    case bitwise_e::XOR:
+      result.i64 = lhs ^ rhs;
+      break;
+    case bitwise_e::NOT:
+      result.i64 = ~lhs;
+      break;
+    }
+    return literal(cell_type_e::I64, result, location);
+  }
+  }
+  return nullptr;
+}
+
+void optimizer_c::prune(cell_ptr &cell, bool top) {
+  // (if cond then [else])
+  auto &list = cell->as_list();
+  if (list.size() < 3 || list.size() > 4 ||
+      list[1]->type != cell_type_e::I64) {
+    return;
+  }
+
+  auto taken = list[1]->data.i64 > 0;
+  if (!taken && list.size() == 3) {
+    // Nothing is taken, which gives the last result
+    return;
+  }
+  auto branch = taken ? list[2] : list[3];
+
+  // The `if` is only replaced when what it gives is evaluated the same
+  // way outside of it, and nothing within it relies on it for a scope
+  auto is_evaluated_alike =
+      is_instruction(branch) || (!top && branch->type != cell_type_e::LIST);
+  if (is_evaluated_alike && is_scope_free(branch)) {
+    cell = branch;
+    return;
+  }
+
+  if (taken && list.size() == 3) {
+    return;
+  }
+  cell_c::data_u condition{0};
+  condition.i64 = 1;
+  auto pruned = cell_list_t{
+      list[0], literal(cell_type_e::I64, condition, list[1]->get_location()),
+      branch};
+  list = std::move(pruned);
+}
+
+bool optimizer_c::is_scope_free(cell_ptr &cell) {
+  if (cell->type != cell_type_e::LIST) {
+    return true;
+  }
+
+  auto &list = cell->as_list();
+  if (is_instruction(cell) && !list.empty()) {
+    // Calls through anything other than a builtin may be to a macro,
+    // which expands into the scope it is called in
+    auto *fn = builtin_of(list[0]);
+    if (!fn || uses_scope(*fn)) {
+      return false;
+    }
+  }
+
+  for (auto &item : list) {
+    if (!is_scope_free(item)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace nibi
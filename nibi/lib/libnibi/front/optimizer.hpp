@@ -0,0 +1,39 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+#include "libnibi/types.hpp"
+
+namespace nibi {
+
+//! \brief Simplifies instructions after they are parsed and before
+//!        they are handed on to be processed
+//! \note  Calls to pure builtins (arithmetic, comparison and bitwise)
+//!        with only numeric literals for arguments are folded into the
+//!        literal they would give, and an `if` with a literal condition
+//!        loses the branch it can never take. Only calls made through
+//!        the builtins of the router are touched, anything else may
+//!        mean something different by the time it is processed
+class optimizer_c {
+public:
+  optimizer_c() = delete;
+
+  //! \brief Construct the optimizer
+  //! \param router Map of symbols to the builtins they were parsed as
+  optimizer_c(function_router_t &router) : router_(router) {}
+
+  //! \brief Optimize an instruction in place
+  //! \param instruction The instruction to optimize. It is only ever
+  //!        replaced by another instruction list
+  void optimize(cell_ptr &instruction);
+
+private:
+  function_router_t &router_;
+
+  function_info_s *builtin_of(cell_ptr &cell);
+  void simplify(cell_ptr &cell, bool top);
+  cell_ptr fold(cell_ptr &cell, function_info_s &fn);
+  void prune(cell_ptr &cell, bool top);
+  bool is_scope_free(cell_ptr &cell);
+};
+
+} // namespace nibi
@@ -28,25 +28,25 @@ enum class token_e {
 class token_c {
 public:
   //! \brief Create a token.
-  //! \param locator The locator interface.
+  //! \param location The location of the token.
   //! \param token The token value.
-  token_c(locator_ptr locator, const token_e token)
-      : locator_(locator), token_(token) {}
+  token_c(location_s location, const token_e token)
+      : location_(location), token_(token) {}
   //! \brief Create a token.
-  //! \param locator The locator interface.
+  //! \param location The location of the token.
   //! \param token The token value.
   //! \param data The data associated with the token.
-  token_c(locator_ptr locator, const token_e token, const std::string &data)
-      : locator_(locator), token_(token), data_(data) {}
+  token_c(location_s location, const token_e token, const std::string &data)
+      : location_(location), token_(token), data_(data) {}
   //! \brief Get the token value.
   const token_e get_token() const { return token_; }
-  //! \brief Get the locator interface.
-  const locator_ptr get_locator() const { return locator_; }
+  //! \brief Get the location of the token.
+  const location_s get_location() const { return location_; }
   //! \brief Get the data associated with the token.
   const std::string get_data() const { return data_; }
 
 private:
-  locator_ptr locator_{nullptr};
+  location_s location_;
   token_e token_{token_e::NIL};
   std::string data_{""};
 };
@@ -0,0 +1,141 @@
+#include "verifier.hpp"
+
+#include "libnibi/interpreter/builtins/kernels.hpp"
+#include "libnibi/keywords.hpp"
+
+#include <string>
+
+namespace nibi {
+
+namespace {
+
+inline bool is_name(function_info_s &fn, const char *name) {
+  return fn.name == name;
+}
+
+// Builtins that execute the data lists they are given as bodies
+inline bool takes_bodies(function_info_s &fn) {
+  return is_name(fn, kw::FN) || is_name(fn, kw::IF) ||
+         is_name(fn, kw::LOOP) || is_name(fn, kw::TRY) ||
+         is_name(fn, kw::DEFER);
+}
+
+// Builtins whose arguments are never evaluated as they were written
+inline bool takes_code(function_info_s &fn) {
+  return is_name(fn, kw::QUOTE) || is_name(fn, kw::MACRO);
+}
+
+inline bool is_arithmetic(function_info_s &fn) {
+  return is_name(fn, kw::ADD) || is_name(fn, kw::SUB) ||
+         is_name(fn, kw::MUL) || is_name(fn, kw::DIV) ||
+         is_name(fn, kw::MOD) || is_name(fn, kw::POW);
+}
+
+inline bool is_instruction(cell_ptr &cell) {
+  return cell->type == cell_type_e::LIST &&
+         cell->as_list_info().type == list_types_e::INSTRUCTION;
+}
+
+// Literals that are never a number, whatever they're processed with
+inline bool is_non_numeric_literal(cell_ptr &cell) {
+  return cell->type == cell_type_e::STRING || cell->type == cell_type_e::CHAR;
+}
+
+std::string incorrect_type(cell_type_e type) {
+  return std::string("Incorrect argument type for arithmetic function: ") +
+         cell_type_to_string(type);
+}
+
+} // namespace
+
+bool verifier_c::verify(cell_ptr &instruction) { return check(instruction); }
+
+function_info_s *verifier_c::builtin_of(cell_ptr &cell) {
+  if (cell->type != cell_type_e::FUNCTION ||
+      !(cell->flags & cell_c::SHARED_FN)) {
+    return nullptr;
+  }
+  auto &fn = cell->as_function_info();
+  auto it = router_.find(fn.name);
+  if (it == router_.end() || &it->second != &fn) {
+    return nullptr;
+  }
+  return &fn;
+}
+
+bool verifier_c::check(cell_ptr &cell) {
+  if (!is_instruction(cell)) {
+    return true;
+  }
+
+  auto &list = cell->as_list();
+  if (list.empty()) {
+    return true;
+  }
+
+  auto *fn = builtin_of(list[0]);
+  if (!fn || !takes_code(*fn)) {
+    for (auto &item : list) {
+      if (is_instruction(item)) {
+        if (!check(item)) {
+          return false;
+        }
+      } else if (fn && takes_bodies(*fn) &&
+                 item->type == cell_type_e::LIST &&
+                 item->as_list_info().type == list_types_e::DATA) {
+        for (auto &body_item : item->as_list()) {
+          if (!check(body_item)) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  if (!fn) {
+    return true;
+  }
+
+  auto count = list.size() - 1;
+  if (!fn->arity.accepts(count)) {
+    return fail(list[0]->get_location(), fn->arity_error(count));
+  }
+
+  if (is_arithmetic(*fn) && !check_arithmetic(list, *fn)) {
+    return false;
+  }
+
+  cell->flags |= cell_c::VERIFIED;
+  return true;
+}
+
+bool verifier_c::check_arithmetic(cell_list_t &list, function_info_s &fn) {
+  // A string given first is concatenated by `+` and repeated by `*`,
+  // so what they are given is only known once the first is a number
+  auto takes_strings = is_name(fn, kw::ADD) || is_name(fn, kw::MUL);
+  auto &first = list[1];
+  if (takes_strings && !kernels::is_numeric(first->type)) {
+    if (first->type == cell_type_e::CHAR) {
+      return fail(list[0]->get_location(), incorrect_type(first->type));
+    }
+    return true;
+  }
+
+  if (is_non_numeric_literal(first)) {
+    return fail(list[0]->get_location(), incorrect_type(first->type));
+  }
+
+  for (auto i = list.begin() + 2; i != list.end(); ++i) {
+    if (is_non_numeric_literal(*i)) {
+      return fail((*i)->get_location(), incorrect_type((*i)->type));
+    }
+  }
+  return true;
+}
+
+bool verifier_c::fail(location_s location, std::string message) {
+  error_cb_(error_c(location, message));
+  return false;
+}
+
+} // namespace nibi
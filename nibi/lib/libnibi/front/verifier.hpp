@@ -0,0 +1,46 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+#include "libnibi/error.hpp"
+#include "libnibi/types.hpp"
+
+namespace nibi {
+
+//! \brief Checks instructions after they are optimized and before they
+//!        are handed on to be processed
+//! \note  Calls made through the builtins of the router are checked for
+//!        the number of arguments they are given, and arithmetic is
+//!        checked for string literals where a number is needed. Calls
+//!        that pass are marked as verified so the check isn't made
+//!        again each time they are processed. Anything else may mean
+//!        something different by the time it is processed, and is
+//!        checked when it is called. An instruction that fails halts
+//!        the script as it is read, even where it would never be
+//!        processed, so a literal such as the string in (* 3 "ab") is
+//!        reported there rather than by the call
+class verifier_c {
+public:
+  verifier_c() = delete;
+
+  //! \brief Construct the verifier
+  //! \param router Map of symbols to the builtins they were parsed as
+  //! \param error_cb Callback to report instructions that fail with
+  verifier_c(function_router_t &router, error_callback_f error_cb)
+      : router_(router), error_cb_(error_cb) {}
+
+  //! \brief Verify an instruction and everything within it
+  //! \param instruction The instruction to verify
+  //! \return true iff the instruction can be processed
+  bool verify(cell_ptr &instruction);
+
+private:
+  function_router_t &router_;
+  error_callback_f error_cb_;
+
+  function_info_s *builtin_of(cell_ptr &cell);
+  bool check(cell_ptr &cell);
+  bool check_arithmetic(cell_list_t &list, function_info_s &fn);
+  bool fail(location_s location, std::string message);
+};
+
+} // namespace nibi
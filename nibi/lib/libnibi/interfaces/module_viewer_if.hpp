@@ -7,11 +7,15 @@
 
 namespace nibi {
 
-//! \brief An interface to pull module information
+//! \brief An interface to pull module information, and to compile modules
 class module_viewer_if {
 public:
   virtual ~module_viewer_if() = default;
   virtual module_info_s get_module_info(std::string &directory) = 0;
+
+  //! \brief Compile a module's sources ahead of time
+  //! \return The library that was built
+  virtual std::filesystem::path compile_module(std::string &name) = 0;
 };
 
 } // namespace nibi
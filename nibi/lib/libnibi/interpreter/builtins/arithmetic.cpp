@@ -1,108 +1,102 @@
 #include <iostream>
 
-#include "arithmetic_helpers.hpp"
 #include "interpreter/builtins/builtins.hpp"
+#include "interpreter/builtins/kernels.hpp"
 #include "interpreter/interpreter.hpp"
 #include "libnibi/cell.hpp"
 #include "libnibi/keywords.hpp"
-#include "macros.hpp"
-
-#include <cmath>
 
 namespace nibi {
 
 namespace builtins {
 
-#define PERFORM_OPERATION(___op_fn)                                            \
-  {                                                                            \
-    auto first_arg = ci.process_cell(list[1], env);                            \
-    if (first_arg->is_integer()) {                                             \
-      return allocate_cell(___op_fn<int64_t>(                                  \
-          first_arg->to_integer(), ci,                                         \
-          [](cell_ptr arg) -> int64_t { return arg->to_integer(); }, list,     \
-          env));                                                               \
-    } else if (first_arg->is_float()) {                                        \
-      return allocate_cell(___op_fn<double>(                                   \
-          first_arg->to_double(), ci,                                          \
-          [](cell_ptr arg) -> double { return arg->to_double(); }, list,       \
-          env));                                                               \
-    }                                                                          \
-    std::string msg = "Incorrect argument type for arithmetic function: ";     \
-    msg += cell_type_to_string(first_arg->type);                               \
-    throw interpreter_c::exception_c(msg, list[0]->locator);                   \
+namespace {
+
+[[noreturn]] void throw_incorrect_type(cell_type_e type, location_s location) {
+  std::string msg = "Incorrect argument type for arithmetic function: ";
+  msg += cell_type_to_string(type);
+  throw interpreter_c::exception_c(msg, location);
+}
+
+// Fold the arguments of an arithmetic instruction into the first
+cell_ptr fold(kernels::arith_e op, cell_args_t args) {
+  auto &first = args.front();
+  if (!kernels::is_numeric(first->type)) {
+    throw_incorrect_type(first->type, first->get_location());
+  }
+
+  auto type = first->type;
+  auto data = first->data;
+
+  if (op == kernels::arith_e::SUB && args.size() == 1) {
+    // Negation, subtracting from zero of the type being negated
+    type = kernels::result_type(op, first->type);
+    data.u64 = 0;
+    kernels::arithmetic(op, type, data, first->type, first->data);
+  }
+
+  for (auto &arg : args.subspan(1)) {
+    if (!kernels::is_numeric(arg->type)) {
+      throw_incorrect_type(arg->type, arg->get_location());
+    }
+    if (kernels::arithmetic(op, type, data, arg->type, arg->data) !=
+        kernels::result_e::OK) {
+      throw interpreter_c::exception_c("Division by zero", arg->get_location());
+    }
   }
 
-cell_ptr builtin_fn_arithmetic_add(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::ADD, >=, 2)
+  if (type == cell_type_e::I64) {
+    return constant_integer(data.i64);
+  }
+  auto result = allocate_cell(type);
+  result->data = data;
+  return result;
+}
+
+} // namespace
 
-  auto first_item = ci.process_cell(list[1], env);
+cell_ptr builtin_fn_arithmetic_add(interpreter_c &, cell_args_t args, env_c &) {
+  auto &first_item = args.front();
   if (first_item->type == cell_type_e::STRING) {
     std::string accumulate{first_item->to_string()};
-    NIBI_LIST_ITER_AND_LOAD_SKIP_N(2, { accumulate += arg->to_string(); })
+    for (auto &arg : args.subspan(1)) {
+      accumulate += arg->to_string();
+    }
     return allocate_cell(accumulate);
   } else {
-    PERFORM_OPERATION(list_perform_add)
+    return fold(kernels::arith_e::ADD, args);
   }
 }
 
-cell_ptr builtin_fn_arithmetic_sub(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env){
-    NIBI_LIST_ENFORCE_SIZE(nibi::kw::SUB, >=, 2)
-        PERFORM_OPERATION(list_perform_sub)}
-
-cell_ptr
-    builtin_fn_arithmetic_div(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::SUB, >=, 2)
-            PERFORM_OPERATION(list_perform_div)}
+cell_ptr builtin_fn_arithmetic_sub(interpreter_c &, cell_args_t args, env_c &) {
+  return fold(kernels::arith_e::SUB, args);
+}
 
-cell_ptr builtin_fn_arithmetic_mul(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MUL, >=, 2)
+cell_ptr builtin_fn_arithmetic_div(interpreter_c &, cell_args_t args, env_c &) {
+  return fold(kernels::arith_e::DIV, args);
+}
 
-  auto first_item = ci.process_cell(list[1], env);
+cell_ptr builtin_fn_arithmetic_mul(interpreter_c &, cell_args_t args, env_c &) {
+  auto &first_item = args.front();
   if (first_item->type == cell_type_e::STRING) {
     std::string accumulate{first_item->to_string()};
-    NIBI_LIST_ITER_AND_LOAD_SKIP_N(2, {
+    for (auto &arg : args.subspan(1)) {
       int64_t times = arg->to_integer() - 1;
       for (int64_t i = 0; i < times; i++)
         accumulate += first_item->to_string();
-    })
+    }
     return allocate_cell(accumulate);
   } else {
-    PERFORM_OPERATION(list_perform_mul)
+    return fold(kernels::arith_e::MUL, args);
   }
 }
 
-cell_ptr builtin_fn_arithmetic_mod(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MOD, >=, 2)
-  auto first_arg = ci.process_cell(list[1], env);
-  if (first_arg->type == cell_type_e::F32 ||
-      first_arg->type == cell_type_e::F64) {
-    double accumulate{first_arg->to_double()};
-    NIBI_LIST_ITER_AND_LOAD_SKIP_N(
-        2, { accumulate = std::fmod(accumulate, arg->to_double()); })
-
-    // Ensure we keep the same type for the data
-    auto c = allocate_cell(first_arg->type);
-    c->data.f64 = accumulate;
-    return c;
-  } else {
-    int64_t accumulate{first_arg->to_integer()};
-    NIBI_LIST_ITER_AND_LOAD_SKIP_N(2, { accumulate %= arg->to_integer(); })
-
-    // Ensure we keep the same type for the data
-    auto c = allocate_cell(first_arg->type);
-    c->data.i64 = accumulate;
-    return c;
-  }
+cell_ptr builtin_fn_arithmetic_mod(interpreter_c &, cell_args_t args, env_c &) {
+  return fold(kernels::arith_e::MOD, args);
 }
 
-cell_ptr builtin_fn_arithmetic_pow(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::POW, >=, 2)
-  PERFORM_OPERATION(list_perform_pow)
+cell_ptr builtin_fn_arithmetic_pow(interpreter_c &, cell_args_t args, env_c &) {
+  return fold(kernels::arith_e::POW, args);
 }
 
 } // namespace builtins
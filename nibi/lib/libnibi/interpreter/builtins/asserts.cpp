@@ -13,33 +13,32 @@ namespace builtins {
 cell_ptr builtin_fn_assert_true(interpreter_c &ci, cell_list_t &list,
                                 env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::ASSERT, >=, 2)
-
   auto value = ci.process_cell(list[1], env);
   if (!value->is_integer()) {
     throw interpreter_c::exception_c(
-        "Expected item to evaluate to integer type", list[1]->locator);
+        "Expected item to evaluate to integer type", list[1]->get_location());
   }
 
   if (list.size() == 2) {
     if (value->as_integer() == 0) {
-      throw interpreter_c::exception_c("Assertion failed", list[0]->locator);
+      throw interpreter_c::exception_c("Assertion failed",
+                                       list[0]->get_location());
     }
-    return allocate_cell(cell_type_e::NIL);
+    return constant_nil();
   }
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::ASSERT, ==, 3)
-
   if (value->as_integer() == 0) {
     auto message = ci.process_cell(list[2], env);
     if (message->type != cell_type_e::STRING) {
       throw interpreter_c::exception_c(
-          "Expected string value for assertion message", message->locator);
+          "Expected string value for assertion message",
+          message->get_location());
     }
-    throw interpreter_c::exception_c(message->as_string(), list[0]->locator);
+    throw interpreter_c::exception_c(message->as_string(),
+                                     list[0]->get_location());
   }
 
-  return allocate_cell(cell_type_e::NIL);
+  return constant_nil();
 }
 
 } // namespace builtins
@@ -25,6 +25,53 @@ function_router_t &get_builtin_symbols_map();
 extern cell_ptr execute_suspected_lambda(interpreter_c &ci, cell_list_t &list,
                                          env_c &env);
 
+//! \brief Evaluate the arguments of a call to a lambda function
+//! \param fn_info The lambda function being called
+//! \param list The list containing the lambda function and args
+//! \param env The environment of the caller
+//! \return The values to bind to the parameters of the lambda
+extern cell_list_t evaluate_lambda_arguments(interpreter_c &ci,
+                                             function_info_s &fn_info,
+                                             cell_list_t &list, env_c &env);
+
+//! \brief Call a builtin that takes its arguments evaluated, for callers
+//!        that only have its cell_fn_t, see interpreter_c::call_eager
+//! \param fn The builtin
+//! \param list The list containing the builtin and args
+//! \param env The environment of the caller
+extern cell_ptr call_evaluated(interpreter_c &ci, cell_eager_fn_t fn,
+                               cell_list_t &list, env_c &env);
+
+//! \brief The cell_fn_t of a builtin that takes its arguments evaluated,
+//!        for calls made with the arguments of an instruction
+template <cell_eager_fn_t Fn>
+cell_ptr evaluated(interpreter_c &ci, cell_list_t &list, env_c &env) {
+  return call_evaluated(ci, Fn, list, env);
+}
+
+//! \brief Determine what the scope opened by an `if`, `loop` or `try`
+//!        instruction is needed for
+//! \param list The instruction
+//! \return cell_c::SCOPE_ENV if anything within the instruction binds a
+//!         name into its environment, and cell_c::SCOPE_CTX if anything
+//!         defers to its context. Neither needs to be opened otherwise
+//! \note  The result is cached on the head of the instruction. Calls to
+//!        macros are assumed to need both, as a macro expands in place
+extern uint8_t form_scope(cell_list_t &list);
+
+//! \brief Determine what the arguments of a call to a lambda need of
+//!        the scope the call is made in, as for form_scope
+//! \param cell The instruction list of the call
+//! \note  The result is cached on the instruction
+extern uint8_t call_scope(cell_ptr &cell);
+
+//! \brief Select the branch of an `if` instruction to take
+//! \param list The `if` instruction, given arguments its arity accepts
+//! \param if_env The environment the condition and branch execute in
+//! \return The branch to take, or nullptr if there is none
+extern cell_ptr select_if_branch(interpreter_c &ci, cell_list_t &list,
+                                 env_c &if_env);
+
 // Environment modification functions
 
 extern cell_ptr builtin_fn_env_alias(interpreter_c &ci, cell_list_t &list,
@@ -70,7 +117,7 @@ extern cell_ptr builtin_fn_list_pop_back(interpreter_c &ci, cell_list_t &list,
 
 extern cell_ptr builtin_fn_common_clone(interpreter_c &ci, cell_list_t &list,
                                         env_c &env);
-extern cell_ptr builtin_fn_common_len(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_common_len(interpreter_c &ci, cell_args_t args,
                                       env_c &env);
 extern cell_ptr builtin_fn_common_yield(interpreter_c &ci, cell_list_t &list,
                                         env_c &env);
@@ -104,51 +151,51 @@ extern cell_ptr builtin_fn_assert_true(interpreter_c &ci, cell_list_t &list,
 
 // Arithmetic functions
 
-extern cell_ptr builtin_fn_arithmetic_add(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_arithmetic_add(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_arithmetic_sub(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_arithmetic_sub(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_arithmetic_div(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_arithmetic_div(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_arithmetic_mul(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_arithmetic_mul(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_arithmetic_mod(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_arithmetic_mod(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_arithmetic_pow(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_arithmetic_pow(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
 
 // Bitwise functions
 
-extern cell_ptr builtin_fn_bitwise_lsh(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_bitwise_lsh(interpreter_c &ci, cell_args_t args,
                                        env_c &env);
-extern cell_ptr builtin_fn_bitwise_rsh(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_bitwise_rsh(interpreter_c &ci, cell_args_t args,
                                        env_c &env);
-extern cell_ptr builtin_fn_bitwise_and(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_bitwise_and(interpreter_c &ci, cell_args_t args,
                                        env_c &env);
-extern cell_ptr builtin_fn_bitwise_or(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_bitwise_or(interpreter_c &ci, cell_args_t args,
                                       env_c &env);
-extern cell_ptr builtin_fn_bitwise_xor(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_bitwise_xor(interpreter_c &ci, cell_args_t args,
                                        env_c &env);
-extern cell_ptr builtin_fn_bitwise_not(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_bitwise_not(interpreter_c &ci, cell_args_t args,
                                        env_c &env);
 
 // Comparison functions
 
-extern cell_ptr builtin_fn_comparison_eq(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_eq(interpreter_c &ci, cell_args_t args,
                                          env_c &env);
-extern cell_ptr builtin_fn_comparison_neq(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_neq(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_comparison_lt(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_lt(interpreter_c &ci, cell_args_t args,
                                          env_c &env);
-extern cell_ptr builtin_fn_comparison_gt(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_gt(interpreter_c &ci, cell_args_t args,
                                          env_c &env);
-extern cell_ptr builtin_fn_comparison_lte(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_lte(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_comparison_gte(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_gte(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_comparison_and(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_and(interpreter_c &ci, cell_args_t args,
                                           env_c &env);
-extern cell_ptr builtin_fn_comparison_or(interpreter_c &ci, cell_list_t &list,
+extern cell_ptr builtin_fn_comparison_or(interpreter_c &ci, cell_args_t args,
                                          env_c &env);
 extern cell_ptr builtin_fn_comparison_not(interpreter_c &ci, cell_list_t &list,
                                           env_c &env);
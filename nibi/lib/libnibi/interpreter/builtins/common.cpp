@@ -1,21 +1,30 @@
 
 #include "interpreter/builtins/builtins.hpp"
+#include "interpreter/builtins/kernels.hpp"
 #include "interpreter/interpreter.hpp"
 #include "libnibi/cell.hpp"
 #include "libnibi/front/file_interpreter.hpp"
+#include "libnibi/front/optimizer.hpp"
 #include "libnibi/keywords.hpp"
 #include "macros.hpp"
 #include "platform.hpp"
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
 
 namespace nibi {
 namespace builtins {
 
+cell_ptr call_evaluated(interpreter_c &ci, cell_eager_fn_t fn,
+                        cell_list_t &list, env_c &env) {
+  return ci.call_eager(fn, list, env);
+}
+
 cell_ptr builtin_fn_common_clone(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::CLONE, ==, 2)
-
   auto it = list.begin();
   std::advance(it, 1);
 
@@ -24,24 +33,21 @@ cell_ptr builtin_fn_common_clone(interpreter_c &ci, cell_list_t &list,
   return loaded_cell->clone(env);
 }
 
-cell_ptr builtin_fn_common_len(interpreter_c &ci, cell_list_t &list,
-                               env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::LEN, ==, 2)
-
-  auto target_list = ci.process_cell(list[1], env);
+cell_ptr builtin_fn_common_len(interpreter_c &, cell_args_t args, env_c &) {
+  auto &target_list = args[0];
 
   if (target_list->type != cell_type_e::LIST) {
-    return allocate_cell((int64_t)(target_list->to_string(false, true).size()));
+    return constant_integer(
+        (int64_t)(target_list->to_string(false, true).size()));
   }
 
-  auto &list_info = target_list->as_list_info();
-  return allocate_cell((int64_t)list_info.list.size());
+  auto &list_info = target_list->read_list_info();
+  return constant_integer((int64_t)list_info.list.size());
 }
 
 cell_ptr builtin_fn_common_exchange(interpreter_c &ci, cell_list_t &list,
                                     env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::EXCHANGE, ==, 3)
-  auto target = ci.process_cell(list[1], env);
+  auto target = env.writable(ci.process_cell(list[1], env), list[1]);
   auto source = ci.process_cell(list[2], env);
   auto result = target->clone(env);
   target->update_from(*source, env);
@@ -50,38 +56,245 @@ cell_ptr builtin_fn_common_exchange(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_common_defer(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::DEFER, >=, 2)
-
   for (auto it = list.begin() + 1; it != list.end(); ++it) {
     if ((*it)->type != cell_type_e::LIST) {
       throw interpreter_c::exception_c(
           "Defer command requires all parameters to be of type LIST",
-          (*it)->locator);
+          (*it)->get_location());
     }
     ci.defer_execution(*it);
   }
-  return allocate_cell(cell_type_e::NIL);
+  return constant_nil();
 }
 
 cell_ptr builtin_fn_common_yield(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
-
   if (list.size() == 1) {
-    ci.set_yield_value(allocate_cell((int64_t)0));
+    ci.yield(constant_integer(0));
     return ci.get_yield_value();
   }
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::YIELD, ==, 2)
-
-  auto target = ci.process_cell(list[1], env)->clone(env);
-  ci.set_yield_value(target);
+  // Nothing is yielded by a value that is cut short
+  auto target = ci.process_statement(list[1], env, false);
+  if (ci.is_completing()) {
+    return target;
+  }
+  target = target->clone(env);
+  ci.yield(target);
   return target;
 }
 
+namespace {
+
+static constexpr uint8_t SCOPE_ALL = cell_c::SCOPE_ENV | cell_c::SCOPE_CTX;
+
+// Names that macros have been defined with. A call through one of them
+// expands in place, so may bind or defer into the scope it is made in
+std::mutex macro_names_lock;
+std::unordered_set<symbol_id_t> macro_names;
+
+bool is_macro_name(symbol_id_t id) {
+  std::lock_guard<std::mutex> lock(macro_names_lock);
+  return macro_names.contains(id);
+}
+
+uint8_t scope_needs(cell_ptr &cell);
+
+uint8_t scope_needs(cell_list_t &list, std::size_t from) {
+  uint8_t needs{0};
+  for (auto i = from; i < list.size(); i++) {
+    needs |= scope_needs(list[i]);
+  }
+  return needs;
+}
+
+// What evaluating a cell needs of the scope it is evaluated in. The
+// scope of an `if`, `loop` or `try` within it is that form's own,
+// other than for what they evaluate directly in the enclosing one
+uint8_t scope_needs(cell_ptr &cell) {
+  if (cell->type != cell_type_e::LIST) {
+    return 0;
+  }
+
+  auto &list_info = cell->as_list_info();
+  auto &list = list_info.list;
+  if (list_info.type != list_types_e::INSTRUCTION || list.empty()) {
+    return scope_needs(list, 0);
+  }
+
+  auto &head = list.front();
+  if (head->type == cell_type_e::SYMBOL) {
+    return is_macro_name(head->as_symbol_id()) ? SCOPE_ALL
+                                               : scope_needs(list, 1);
+  }
+  if (head->type != cell_type_e::FUNCTION ||
+      head->as_function_info().type != function_type_e::BUILTIN_CPP_FUNCTION) {
+    return scope_needs(list, 0);
+  }
+
+  auto &name = head->as_function_info().name;
+  if (name == kw::IF) {
+    // Only the condition is evaluated within the context of an `if`,
+    // the branches defer to the context enclosing it
+    return scope_needs(list, 2) & cell_c::SCOPE_CTX;
+  }
+  if (name == kw::LOOP) {
+    return 0;
+  }
+  if (name == kw::TRY) {
+    // The attempt is made in the enclosing environment
+    return list.size() > 1 ? scope_needs(list[1]) & cell_c::SCOPE_ENV : 0;
+  }
+  if (name == kw::ASSIGN || name == kw::FN || name == kw::MACRO ||
+      name == kw::ALIAS || name == kw::EVAL) {
+    return cell_c::SCOPE_ENV | scope_needs(list, 1);
+  }
+  if (name == kw::DEFER) {
+    return cell_c::SCOPE_CTX | scope_needs(list, 1);
+  }
+  return scope_needs(list, 1);
+}
+
+} // namespace
+
+uint8_t form_scope(cell_list_t &list) {
+  auto &head = list.front();
+  if (head->flags & cell_c::SCOPE_KNOWN) {
+    return head->flags & SCOPE_ALL;
+  }
+
+  // Forms reached through anything other than their builtin
+  // are rare enough to not be worth analyzing
+  if (head->type != cell_type_e::FUNCTION) {
+    return SCOPE_ALL;
+  }
+
+  auto needs = scope_needs(list, 1);
+  auto &name = head->as_function_info().name;
+  if (name == kw::IF && list.size() > 1) {
+    // The context is only open while the condition is evaluated
+    needs = (needs & cell_c::SCOPE_ENV) |
+            (scope_needs(list[1]) & cell_c::SCOPE_CTX);
+  } else if (name == kw::TRY) {
+    // The attempt is made in the enclosing environment,
+    // only the recovery is made in that of the `try`
+    needs &= cell_c::SCOPE_CTX;
+  }
+
+  head->flags |= cell_c::SCOPE_KNOWN | needs;
+  return needs;
+}
+
+uint8_t call_scope(cell_ptr &cell) {
+  // Unlike a form, the head of a call may be shared with other
+  // instructions, so what is known is kept on the instruction
+  if (cell->flags & cell_c::SCOPE_KNOWN) {
+    return cell->flags & SCOPE_ALL;
+  }
+  auto needs = scope_needs(cell);
+  cell->flags |= cell_c::SCOPE_KNOWN | needs;
+  return needs;
+}
+
+namespace {
+
+// A loop of the form (loop (:= i start) (< i limit) (set i (+ i step)) body)
+// that counts an integer towards a limit
+struct counted_range_s {
+  symbol_id_t counter;
+  kernels::cmp_e cmp;
+  cell_ptr limit;
+  int64_t step;
+};
+
+// Get the arguments of a call to a builtin, if that is what the cell is
+cell_list_t *builtin_call(cell_ptr &cell, const char *name,
+                          std::size_t arguments) {
+  if (cell->type != cell_type_e::LIST) {
+    return nullptr;
+  }
+  auto &list_info = cell->as_list_info();
+  auto &list = list_info.list;
+  if (list_info.type != list_types_e::INSTRUCTION ||
+      list.size() != arguments + 1 ||
+      list[0]->type != cell_type_e::FUNCTION) {
+    return nullptr;
+  }
+  auto &fn_info = list[0]->as_function_info();
+  if (fn_info.type != function_type_e::BUILTIN_CPP_FUNCTION ||
+      fn_info.name != name) {
+    return nullptr;
+  }
+  return &list;
+}
+
+bool is_symbol(cell_ptr &cell, symbol_id_t id) {
+  return cell->type == cell_type_e::SYMBOL && cell->as_symbol_id() == id;
+}
+
+std::optional<counted_range_s> match_counted_range(cell_ptr &pre,
+                                                   cell_ptr &condition,
+                                                   cell_ptr &post) {
+  auto *init = builtin_call(pre, kw::ASSIGN, 2);
+  if (!init) {
+    init = builtin_call(pre, kw::SET, 2);
+  }
+  if (!init || (*init)[1]->type != cell_type_e::SYMBOL) {
+    return std::nullopt;
+  }
+  auto counter = (*init)[1]->as_symbol_id();
+
+  static constexpr std::pair<const char *, kernels::cmp_e> comparisons[] = {
+      {kw::LT, kernels::cmp_e::LT},
+      {kw::LTE, kernels::cmp_e::LTE},
+      {kw::GT, kernels::cmp_e::GT},
+      {kw::GTE, kernels::cmp_e::GTE}};
+
+  std::optional<counted_range_s> range;
+  for (auto &[name, cmp] : comparisons) {
+    if (auto *test = builtin_call(condition, name, 2);
+        test && is_symbol((*test)[1], counter)) {
+      range = counted_range_s{counter, cmp, (*test)[2], 0};
+      break;
+    }
+  }
+  if (!range) {
+    return std::nullopt;
+  }
+
+  auto *update = builtin_call(post, kw::SET, 2);
+  if (!update || !is_symbol((*update)[1], counter)) {
+    return std::nullopt;
+  }
+
+  auto *step = builtin_call((*update)[2], kw::ADD, 2);
+  auto negate = !step;
+  if (negate) {
+    step = builtin_call((*update)[2], kw::SUB, 2);
+  }
+  if (!step || !is_symbol((*step)[1], counter) ||
+      (*step)[2]->type != cell_type_e::I64) {
+    return std::nullopt;
+  }
+
+  range->step = negate ? -(*step)[2]->data.i64 : (*step)[2]->data.i64;
+  return range;
+}
+
+// Get the counter of a counted range if it can be stepped in place
+cell_c *counter_of(counted_range_s &range, env_c &env) {
+  auto cell = env.get(range.counter);
+  if (!cell || cell->type != cell_type_e::I64 || cell->is_constant()) {
+    return nullptr;
+  }
+  return cell.get();
+}
+
+} // namespace
+
 cell_ptr builtin_fn_common_loop(interpreter_c &ci, cell_list_t &list,
                                 env_c &env) {
   // (loop (pre) (cond) (post) (body))
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::LOOP, ==, 5)
 
   auto it = list.begin();
   std::advance(it, 1);
@@ -97,38 +310,64 @@ cell_ptr builtin_fn_common_loop(interpreter_c &ci, cell_list_t &list,
 
   auto body = (*it);
 
-  ci.push_ctx();
+  // Iterations are run directly in the enclosing scope
+  // when nothing within the loop would use its own
+  auto scope = form_scope(list);
+  auto has_ctx = (scope & cell_c::SCOPE_CTX) != 0;
 
-  auto loop_env = env_c(&env);
+  if (has_ctx) {
+    ci.push_ctx();
+  }
 
-  ci.process_cell(pre_condition, loop_env);
+  std::optional<env_c> scope_env;
+  auto &loop_env =
+      (scope & cell_c::SCOPE_ENV) ? scope_env.emplace(&env) : env;
 
-  cell_ptr result = allocate_cell(cell_type_e::NIL);
-  while (!ci.is_terminating()) {
-    auto condition_result = ci.process_cell(condition, loop_env);
+  ci.process_cell(pre_condition, loop_env);
 
-    if (condition_result->to_integer() <= 0) {
-      return result;
+  // Counted ranges keep the counter's cell and step it in place, rather
+  // than evaluating the condition and update as instructions. Either is
+  // evaluated as written whenever the counter has stopped being a plain
+  // integer, as it may be rebound or set to anything within the body
+  auto range = match_counted_range(pre_condition, condition, post_condition);
+
+  cell_ptr result = constant_nil();
+  while (true) {
+    auto *counter = range ? counter_of(*range, loop_env) : nullptr;
+    auto limit = counter ? ci.process_cell(range->limit, loop_env) : nullptr;
+
+    if (limit && kernels::is_numeric(limit->type)) {
+      if (!kernels::compare(range->cmp, cell_type_e::I64, counter->data,
+                            limit->type, limit->data)) {
+        break;
+      }
+    } else if (ci.process_cell(condition, loop_env)->to_integer() <= 0) {
+      break;
     }
 
-    result = ci.process_cell(body, loop_env, true);
+    result = ci.process_statement(body, loop_env);
 
-    if (ci.is_yielding()) {
-      return ci.get_yield_value();
+    if (ci.is_completing()) {
+      result = ci.get_completion_value();
+      break;
     }
 
-    ci.process_cell(post_condition, loop_env);
+    if (auto *counter = range ? counter_of(*range, loop_env) : nullptr) {
+      counter->data.i64 += range->step;
+    } else {
+      ci.process_cell(post_condition, loop_env);
+    }
   }
 
-  ci.pop_ctx(loop_env);
+  if (has_ctx) {
+    ci.pop_ctx(loop_env);
+  }
 
   return result;
 }
 
-cell_ptr builtin_fn_common_if(interpreter_c &ci, cell_list_t &list,
-                              env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::IF, >=, 3)
-
+cell_ptr select_if_branch(interpreter_c &ci, cell_list_t &list,
+                          env_c &if_env) {
   auto it = list.begin();
   std::advance(it, 1);
 
@@ -137,23 +376,38 @@ cell_ptr builtin_fn_common_if(interpreter_c &ci, cell_list_t &list,
 
   auto true_condition = (*it);
 
-  auto if_env = env_c(&env);
-
-  ci.push_ctx();
+  auto has_ctx = (form_scope(list) & cell_c::SCOPE_CTX) != 0;
+  if (has_ctx) {
+    ci.push_ctx();
+  }
 
   auto condition_result = ci.process_cell(condition, if_env);
 
-  if (condition_result->as_integer() > 0) {
+  if (has_ctx) {
     ci.pop_ctx(if_env);
-    return ci.process_cell(true_condition, if_env, true);
+  }
+
+  if (condition_result->as_integer() > 0) {
+    return true_condition;
   }
 
   if (list.size() == 4) {
     std::advance(it, 1);
-    ci.pop_ctx(if_env);
-    return ci.process_cell((*it), if_env, true);
+    return (*it);
+  }
+
+  return nullptr;
+}
+
+cell_ptr builtin_fn_common_if(interpreter_c &ci, cell_list_t &list,
+                              env_c &env) {
+  std::optional<env_c> scope_env;
+  auto &if_env =
+      (form_scope(list) & cell_c::SCOPE_ENV) ? scope_env.emplace(&env) : env;
+
+  if (auto branch = select_if_branch(ci, list, if_env)) {
+    return ci.process_statement(branch, if_env);
   }
-  ci.pop_ctx(if_env);
 
   return ci.get_last_result();
 }
@@ -161,8 +415,6 @@ cell_ptr builtin_fn_common_if(interpreter_c &ci, cell_list_t &list,
 cell_ptr builtin_fn_common_import(interpreter_c &ci, cell_list_t &list,
                                   env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::IMPORT, >=, 2)
-
   auto it = list.begin();
   std::advance(it, 1);
 
@@ -177,8 +429,8 @@ cell_ptr builtin_fn_common_import(interpreter_c &ci, cell_list_t &list,
     // Get the source file from the `import` keyword so we can ensure that
     // the file can be searched relative to the location of the file being
     // executed at the moment
-    auto from =
-        std::filesystem::path((*list.begin())->locator->get_source_name());
+    auto from = std::filesystem::path(
+        (*list.begin())->get_location().get_source_name());
 
     // Retrieve the file name to import
     auto target = std::filesystem::path((*it)->as_string());
@@ -189,7 +441,7 @@ cell_ptr builtin_fn_common_import(interpreter_c &ci, cell_list_t &list,
     if (!item.has_value()) {
       throw interpreter_c::exception_c("Could not locate file for import: " +
                                            target.string(),
-                                       (*it)->locator);
+                                       (*it)->get_location());
     }
 
     // Check that the item hasn't already been imported
@@ -199,14 +451,12 @@ cell_ptr builtin_fn_common_import(interpreter_c &ci, cell_list_t &list,
     }
     std::advance(it, 1);
   }
-  return allocate_cell((int64_t)1);
+  return constant_integer(1);
 }
 
 cell_ptr builtin_fn_common_use(interpreter_c &ci, cell_list_t &list,
                                env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::USE, >=, 2)
-
   auto it = list.begin();
   std::advance(it, 1);
 
@@ -214,12 +464,11 @@ cell_ptr builtin_fn_common_use(interpreter_c &ci, cell_list_t &list,
     ci.load_module((*it));
     std::advance(it, 1);
   }
-  return allocate_cell((int64_t)1);
+  return constant_integer(1);
 }
 
 cell_ptr builtin_fn_common_exit(interpreter_c &ci, cell_list_t &list,
                                 env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::EXIT, ==, 2)
   auto it = list.begin();
   std::advance(it, 1);
   std::exit(ci.process_cell((*it), env)->as_integer());
@@ -227,120 +476,234 @@ cell_ptr builtin_fn_common_exit(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_common_quote(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::QUOTE, ==, 2)
   auto it = list.begin();
   std::advance(it, 1);
   return allocate_cell((*it)->to_string(false, true));
 }
 
+namespace {
+
+bool holds_data(const cell_list_t &cells);
+
+// Check if a cell is the body of a `loop`, or a branch of an `if`, which
+// are run as blocks and give the value of their last item
+bool is_block(const cell_list_t &list, std::size_t index) {
+  auto &head = list.front();
+  if (head->type != cell_type_e::FUNCTION ||
+      head->as_function_info().type != function_type_e::BUILTIN_CPP_FUNCTION) {
+    return false;
+  }
+  auto &name = head->as_function_info().name;
+  if (name == kw::LOOP) {
+    return list.size() == 5 && index == 4;
+  }
+  return name == kw::IF && index >= 2;
+}
+
+// Check if a cell holds a data list that evaluates to itself, rather
+// than being run as a block, and so may be modified in place
+bool holds_data(const cell_ptr &cell) {
+  if (cell->type != cell_type_e::LIST) {
+    return false;
+  }
+  auto &list_info = cell->read_list_info();
+  auto &list = list_info.list;
+  if (list_info.type == list_types_e::DATA) {
+    return true;
+  }
+  if (list_info.type != list_types_e::INSTRUCTION || list.empty()) {
+    return holds_data(list);
+  }
+  for (std::size_t i = 0; i < list.size(); i++) {
+    auto &item = list[i];
+    if (is_block(list, i) && item->type == cell_type_e::LIST &&
+        item->read_list_info().type == list_types_e::DATA &&
+        !item->read_list().empty()) {
+      if (holds_data(item->read_list())) {
+        return true;
+      }
+    } else if (holds_data(item)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool holds_data(const cell_list_t &cells) {
+  return std::any_of(cells.begin(), cells.end(),
+                     [](const cell_ptr &cell) { return holds_data(cell); });
+}
+
+// Execute instructions that are kept to be executed again. Those that
+// hold data lists are executed as a copy, so that nothing they are
+// given to modify is kept from one execution to the next. The copy is
+// lowered on its own, as a lowered chunk refers to the cells it was
+// lowered from
+cell_ptr execute_kept(interpreter_c &ci, cell_list_t &cells,
+                      std::vector<std::optional<std::shared_ptr<vm::chunk_c>>>
+                          &lowered,
+                      bool in_place, env_c &env) {
+  cell_ptr result = constant_nil();
+  for (std::size_t i = 0; i < cells.size(); i++) {
+    if (in_place) {
+      result = ci.execute(cells[i], env, lowered[i]);
+    } else {
+      auto copy = cells[i]->clone(env, false);
+      result = ci.execute(copy, env);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 cell_ptr builtin_fn_common_eval(interpreter_c &ci, cell_list_t &list,
                                 env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::EVAL, ==, 2)
   auto it = list.begin();
   std::advance(it, 1);
 
-  auto sm = ci.get_source_manager();
-  auto so = sm.get_source(list[0]->locator->get_source_name());
-
-  // Intercept all instructions generated by intake_c
-  // and store them in a vector
-  class catcher_c : public instruction_processor_if {
-  public:
-    catcher_c(std::vector<cell_ptr> &ins) : ins_(ins) {}
-    void instruction_ind(cell_ptr &cell) override { ins_.push_back(cell); }
+  auto source = ci.process_cell((*it), env)->as_string();
+  auto location = list[0]->get_location();
+
+  // Source evaluated from the same place before is executed as it was
+  // parsed the first time
+  auto &cache = ci.get_eval_cache();
+  auto program = cache.find(location, source);
+  if (!program) {
+    // Intercept all instructions generated by intake_c
+    // and store them in a vector
+    class catcher_c : public instruction_processor_if {
+    public:
+      catcher_c(std::vector<cell_ptr> &ins) : ins_(ins) {}
+      void instruction_ind(cell_ptr &cell) override { ins_.push_back(cell); }
+
+    public:
+      std::vector<cell_ptr> &ins_;
+    };
+
+    std::vector<cell_ptr> instructions;
+    catcher_c ins_catch(instructions);
+
+    auto &sm = ci.get_source_manager();
+    intake_c(
+        ins_catch,
+        [&](error_c error) {
+          error.draw();
+          throw interpreter_c::exception_c("Eval error: " +
+                                           error.get_message());
+        },
+        sm, builtins::get_builtin_symbols_map())
+        .evaluate(source, sm.get_source(location.get_source_name()),
+                  location);
+
+    program = cache.insert(location, std::move(source),
+                           std::move(instructions));
+    program->in_place = !holds_data(program->instructions);
+  }
 
-  public:
-    std::vector<cell_ptr> &ins_;
-  };
+  return execute_kept(ci, program->instructions, program->lowered,
+                      program->in_place, env);
+}
 
-  std::vector<cell_ptr> instructions;
-  instructions.reserve(100);
+cell_ptr builtin_fn_common_nop(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  return constant_nil();
+}
 
-  catcher_c ins_catch(instructions);
+namespace {
 
-  // Evaluate the source code
-  intake_c(
-      ins_catch,
-      [&](error_c error) {
-        error.draw();
-        throw interpreter_c::exception_c("Eval error");
-      },
-      sm, builtins::get_builtin_symbols_map())
-      .evaluate(ci.process_cell((*it), env)->as_string(), so, list[0]->locator);
+// Expansions a macro keeps before they are all dropped, so that those
+// made for call sites that are only ever made once, such as calls
+// in source evaluated once, don't accumulate
+static constexpr std::size_t MAX_MACRO_EXPANSIONS = 1024;
 
-  // Process the instructions
-  cell_ptr result = allocate_cell(cell_type_e::NIL);
-  for (auto &ins : instructions) {
-    result = ci.process_cell(ins, env);
+// Substitute the arguments of a call for the parameters of a macro
+// throughout a copy of its body
+void substitute(cell_ptr &cell, macro_info_s &macro, cell_list_t &list,
+                env_c &env) {
+  if (cell->type == cell_type_e::LIST) {
+    for (auto &item : cell->as_list()) {
+      substitute(item, macro, list, env);
+    }
+    return;
+  }
+  if (cell->type != cell_type_e::SYMBOL) {
+    return;
+  }
+  for (std::size_t i = 0; i < macro.params.size(); i++) {
+    if (cell->as_symbol_id() == macro.params[i]) {
+      cell = list[i + 1]->clone(env, false);
+      return;
+    }
   }
-  return result;
 }
 
-cell_ptr builtin_fn_common_nop(interpreter_c &ci, cell_list_t &list,
-                               env_c &env) {
-  return allocate_cell(cell_type_e::NIL);
+// Get the expansion of a macro for a call. The expansion made for the
+// call site is reused for as long as it is called with the same cells
+std::shared_ptr<macro_info_s::expansion_s>
+expand(macro_info_s &macro, cell_list_t &list, env_c &env) {
+  auto it = macro.expansions.find(&list);
+  if (it != macro.expansions.end() &&
+      std::equal(it->second->args.begin(), it->second->args.end(),
+                 list.begin() + 1, list.end(),
+                 [](auto &a, auto &b) { return a.get() == b.get(); })) {
+    return it->second;
+  }
+
+  auto expansion = std::make_shared<macro_info_s::expansion_s>();
+  expansion->args.assign(list.begin() + 1, list.end());
+
+  optimizer_c optimizer(get_builtin_symbols_map());
+  for (auto &cell : macro.body) {
+    auto &expanded = expansion->body.emplace_back(cell->clone(env, false));
+    substitute(expanded, macro, list, env);
+    if (expanded->type == cell_type_e::LIST) {
+      optimizer.optimize(expanded);
+    }
+  }
+  expansion->lowered.resize(expansion->body.size());
+  expansion->in_place = !holds_data(expansion->body);
+
+  if (macro.expansions.size() >= MAX_MACRO_EXPANSIONS) {
+    macro.expansions.clear();
+  }
+  macro.expansions[&list] = expansion;
+  return expansion;
 }
 
+} // namespace
+
 cell_ptr assemble_macro(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
   cell_ptr definition = list[0];
   if (definition->type == cell_type_e::SYMBOL) {
-    definition = env.get(definition->as_symbol());
+    definition = env.get(definition->as_symbol_id());
   }
 
-  auto macro_env = definition->as_function_info().operating_env;
-  auto macro_params = macro_env->get("$params")->as_list_info();
-  auto macro_body = macro_env->get("$body")->as_string();
+  // Held so that the macro outlives its expansion,
+  // even if the expansion redefines it
+  auto macro = definition->as_function_info().macro;
 
-  if (list.size() != macro_params.list.size() + 1) {
+  if (list.size() != macro->params.size() + 1) {
     throw interpreter_c::exception_c(
         std::string("Macro `") + list[0]->as_symbol() + "` expected " +
-            std::to_string(macro_params.list.size()) + " parameters, but " +
+            std::to_string(macro->params.size()) + " parameters, but " +
             std::to_string(list.size() - 1) + " were given",
-        list[0]->locator);
-  }
-
-  for (std::size_t i = 0; i < macro_params.list.size(); i++) {
-    auto &param = macro_params.list[i];
-    auto &arg = list[i + 1];
-    auto target_replacement = "%" + param->as_symbol();
-    auto found = macro_body.find(target_replacement);
-    while (found != std::string::npos) {
-      if (found > 0 && macro_body[found - 1] == '\\') {
-        found = macro_body.find(target_replacement, found + 1);
-        continue;
-      }
-      macro_body.replace(found, target_replacement.size(),
-                         arg->to_string(true, true));
-      found = macro_body.find(target_replacement);
-    }
+        list[0]->get_location());
   }
 
-  cell_list_t eval_list;
-  auto bs = macro_env->get("$body_start");
-  eval_list.emplace_back(bs);
-  eval_list.emplace_back(allocate_cell(macro_body));
-
-  eval_list.back()->locator = bs->locator;
-
-  return builtin_fn_common_eval(ci, eval_list, env);
+  auto expansion = expand(*macro, list, env);
+  return execute_kept(ci, expansion->body, expansion->lowered,
+                      expansion->in_place, env);
 }
 
 cell_ptr builtin_fn_common_macro(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MACRO, >=, 4)
-
   /*
-     For macros, we will construct a callable function that has an owned
-     cell environment.
-
-     We will store the parameter list into the
-     function enviornment wholesale as they should just be symbols
-     that will be replaced in the body of the macro.
-
-     We will also store the function body in this environment
-     as a quoted list.
+     For macros, we will construct a callable function that holds
+     the body of the macro as the cells it was written as, along
+     with the symbols of its parameters (`%` and their name).
 
      Once we create this function object we will store it in
      the current operating enviornment as the macro_name.
@@ -348,55 +711,48 @@ cell_ptr builtin_fn_common_macro(interpreter_c &ci, cell_list_t &list,
      This will allow us to not modify any other part of the code base
      to gain macro functionality. When a macro is called,
      the call will be interpreted as a function pointing to the
-     function above (assemble_macro). From there,
-     the macro will be assembled and then executed in
-     the environment that is given.
+     function above (assemble_macro). From there, the arguments
+     of the call will be substituted for the parameters in a copy
+     of the body, which is then executed in the environment that
+     is given.
    */
 
   auto macro_name = list[1]->as_symbol();
 
-  NIBI_VALIDATE_VAR_NAME(macro_name, list[1]->locator);
+  NIBI_VALIDATE_VAR_NAME(macro_name, list[1]->get_location());
 
   // Expect param list even it its empty
 
-  auto params = list[2]->as_list_info();
+  auto &params = list[2]->as_list_info();
 
   if (params.type != list_types_e::DATA) {
     throw interpreter_c::exception_c(
         "Macro parameters are expected to be a data list '[]'",
-        list[2]->locator);
+        list[2]->get_location());
   }
 
-  function_info_s macro_assembler_fn("assemble_macro", assemble_macro,
-                                     function_type_e::FAUX, new env_c());
-
-  macro_assembler_fn.operating_env->set("$params", list[2]);
+  auto macro = std::make_shared<macro_info_s>();
+  for (auto &param : params.list) {
+    macro->params.push_back(symbols::intern("%" + param->as_symbol()));
+  }
 
   // Everything else should be considered part of the body
-  // and should be quoted and concatenated
+  macro->body.assign(list.begin() + 3, list.end());
 
-  auto it = list.begin();
-  std::advance(it, 3);
+  function_info_s macro_assembler_fn("assemble_macro", assemble_macro,
+                                     function_type_e::FAUX);
+  macro_assembler_fn.macro = std::move(macro);
 
-  auto body_start = (*it);
-  body_start->locator = (*it)->locator;
+  auto resulting_macro = allocate_cell(macro_assembler_fn);
 
-  std::string macro_string_body;
-  while (it != list.end()) {
-    macro_string_body += (*it)->to_string(true, true);
-    std::advance(it, 1);
+  {
+    std::lock_guard<std::mutex> lock(macro_names_lock);
+    macro_names.insert(list[1]->as_symbol_id());
   }
 
-  auto body = allocate_cell(macro_string_body);
-
-  macro_assembler_fn.operating_env->set("$body", body);
-  macro_assembler_fn.operating_env->set("$body_start", body_start);
-
-  auto resulting_macro = allocate_cell(macro_assembler_fn);
-
   env.set(macro_name, resulting_macro);
 
-  return allocate_cell((int64_t)1);
+  return constant_integer(1);
 }
 
 } // namespace builtins
@@ -1,181 +1,83 @@
 #include <iostream>
 
-#include "arithmetic_helpers.hpp"
 #include "interpreter/builtins/builtins.hpp"
+#include "interpreter/builtins/kernels.hpp"
 #include "interpreter/interpreter.hpp"
 #include "libnibi/cell.hpp"
 #include "libnibi/keywords.hpp"
-#include "macros.hpp"
 
 namespace nibi {
 
-#define PERFORM_OP_ALLOW_STRING(___op)                                         \
-  {                                                                            \
-    if (lhs.is_integer()) {                                                    \
-      auto r =                                                                 \
-          allocate_cell((int64_t)(lhs.as_integer() ___op rhs.to_integer()));   \
-      r->locator = locator;                                                    \
-      return std::move(r);                                                     \
-    } else if (lhs.is_float()) {                                               \
-      auto r =                                                                 \
-          allocate_cell((int64_t)(lhs.as_double() ___op rhs.to_double()));     \
-      r->locator = locator;                                                    \
-      return std::move(r);                                                     \
-    } else if (lhs.type == cell_type_e::STRING) {                              \
-      auto r =                                                                 \
-          allocate_cell((int64_t)(lhs.as_string() ___op rhs.to_string()));     \
-      r->locator = locator;                                                    \
-      return std::move(r);                                                     \
-    } else {                                                                   \
-      auto r =                                                                 \
-          allocate_cell((int64_t)(lhs.to_string() ___op rhs.to_string()));     \
-      r->locator = locator;                                                    \
-      return std::move(r);                                                     \
-    }                                                                          \
-  }
-
-#define PERFORM_OP_NO_STRING(___op)                                            \
-  {                                                                            \
-    if (lhs.is_integer()) {                                                    \
-      auto r =                                                                 \
-          allocate_cell((int64_t)(lhs.as_integer() ___op rhs.to_integer()));   \
-      r->locator = locator;                                                    \
-      return std::move(r);                                                     \
-    } else if (lhs.is_float()) {                                               \
-      auto r =                                                                 \
-          allocate_cell((int64_t)(lhs.as_double() ___op rhs.to_double()));     \
-      r->locator = locator;                                                    \
-      return std::move(r);                                                     \
-    } else {                                                                   \
-      throw interpreter_c::exception_c(                                        \
-          "Expected numeric value, got " +                                     \
-              std::string(cell_type_to_string(lhs.type)),                      \
-          lhs.locator);                                                        \
-    }                                                                          \
-  }
-
 namespace builtins {
 
 namespace {
-enum class op_e {
-  EQ,
-  NEQ,
-  LT,
-  GT,
-  LTE,
-  GTE,
-  AND,
-  OR,
-};
 
-cell_ptr perform_op(locator_ptr locator, op_e op, cell_c &lhs, cell_c &rhs,
+using kernels::cmp_e;
+
+[[noreturn]] void throw_not_numeric(cell_c &cell) {
+  std::string msg = "Expected numeric value, got ";
+  msg += cell_type_to_string(cell.type);
+  throw interpreter_c::exception_c(msg, cell.get_location());
+}
+
+cell_ptr perform_op(cmp_e op, cell_c &lhs, cell_c &rhs,
                     bool enforce_numeric = true) {
-  if (enforce_numeric) {
-    if (!lhs.is_numeric()) {
-      throw interpreter_c::exception_c(
-          "Expected numeric value, got " +
-              std::string(cell_type_to_string(lhs.type)),
-          lhs.locator);
-    }
-    if (!rhs.is_numeric()) {
-      throw interpreter_c::exception_c(
-          "Expected numeric value, got " +
-              std::string(cell_type_to_string(rhs.type)),
-          rhs.locator);
+  if (kernels::is_numeric(lhs.type)) {
+    if (!kernels::is_numeric(rhs.type)) {
+      throw_not_numeric(rhs);
     }
+    return constant_integer(
+        kernels::compare(op, lhs.type, lhs.data, rhs.type, rhs.data));
   }
 
-  cell_type_e target_type = lhs.type;
-  switch (op) {
-  case op_e::EQ:
-    PERFORM_OP_ALLOW_STRING(==)
-  case op_e::NEQ:
-    PERFORM_OP_ALLOW_STRING(!=)
-  case op_e::LT:
-    PERFORM_OP_NO_STRING(<)
-  case op_e::GT:
-    PERFORM_OP_NO_STRING(>)
-  case op_e::LTE:
-    PERFORM_OP_NO_STRING(<=)
-  case op_e::GTE:
-    PERFORM_OP_NO_STRING(>=)
-  case op_e::AND:
-    PERFORM_OP_NO_STRING(&&)
-  case op_e::OR:
-    PERFORM_OP_NO_STRING(||)
+  if (enforce_numeric) {
+    throw_not_numeric(lhs);
   }
 
-  throw interpreter_c::exception_c("Unknown comparison operator", lhs.locator);
+  bool equal;
+  if (lhs.type == cell_type_e::STRING && rhs.type == cell_type_e::STRING) {
+    equal = kernels::strings_equal(lhs, rhs);
+  } else if (lhs.type == cell_type_e::STRING) {
+    equal = lhs.as_string() == rhs.to_string();
+  } else {
+    equal = lhs.to_string() == rhs.to_string();
+  }
+  return constant_integer(op == cmp_e::EQ ? equal : !equal);
 }
 } // namespace
 
-cell_ptr builtin_fn_comparison_eq(interpreter_c &ci, cell_list_t &list,
-                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::EQ, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::EQ,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env), false));
+cell_ptr builtin_fn_comparison_eq(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::EQ, *args[0], *args[1], false);
 }
-cell_ptr builtin_fn_comparison_neq(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::NEQ, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::NEQ,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env), false));
+cell_ptr builtin_fn_comparison_neq(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::NEQ, *args[0], *args[1], false);
 }
-cell_ptr builtin_fn_comparison_lt(interpreter_c &ci, cell_list_t &list,
-                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::LT, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::LT,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env)));
+cell_ptr builtin_fn_comparison_lt(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::LT, *args[0], *args[1]);
 }
-cell_ptr builtin_fn_comparison_gt(interpreter_c &ci, cell_list_t &list,
-                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::GT, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::GT,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env)));
+cell_ptr builtin_fn_comparison_gt(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::GT, *args[0], *args[1]);
 }
-cell_ptr builtin_fn_comparison_lte(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::LTE, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::LTE,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env)));
+cell_ptr builtin_fn_comparison_lte(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::LTE, *args[0], *args[1]);
 }
-cell_ptr builtin_fn_comparison_gte(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::GTE, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::GTE,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env)));
+cell_ptr builtin_fn_comparison_gte(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::GTE, *args[0], *args[1]);
 }
-cell_ptr builtin_fn_comparison_and(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::AND, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::AND,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env)));
+cell_ptr builtin_fn_comparison_and(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::AND, *args[0], *args[1]);
 }
-cell_ptr builtin_fn_comparison_or(interpreter_c &ci, cell_list_t &list,
-                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::OR, ==, 3)
-  return std::move(perform_op(list.front()->locator, op_e::OR,
-                              *ci.process_cell(list[1], env),
-                              *ci.process_cell(list[2], env)));
+cell_ptr builtin_fn_comparison_or(interpreter_c &, cell_args_t args, env_c &) {
+  return perform_op(cmp_e::OR, *args[0], *args[1]);
 }
 
 cell_ptr builtin_fn_comparison_not(interpreter_c &ci, cell_list_t &list,
                                    env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::NOT, ==, 2)
   auto it = list.begin();
   std::advance(it, 1);
   auto item_to_negate = ci.process_cell(*it, env, true);
   auto value = item_to_negate->to_integer();
-  auto result = allocate_cell((int64_t)(!value));
-  result->locator = list[0]->locator;
-  return std::move(result);
+  return constant_integer(!value);
 }
 
 } // namespace builtins
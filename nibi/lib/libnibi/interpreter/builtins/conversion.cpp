@@ -20,30 +20,28 @@ namespace builtins {
   } catch (std::invalid_argument & e) {                                        \
     throw interpreter_c::exception_c(                                          \
         std::string("Invalid argument for conversion: ") + value->to_string(), \
-        value->locator);                                                       \
+        value->get_location());                                                \
   } catch (std::out_of_range & e) {                                            \
     throw interpreter_c::exception_c(                                          \
         std::string("Out of range argument for conversion: ") +                \
             value->to_string(),                                                \
-        value->locator);                                                       \
+        value->get_location());                                                \
   } catch (...) {                                                              \
     throw interpreter_c::exception_c(                                          \
         std::string("Unknown error in conversion: ") + value->to_string(),     \
-        value->locator);                                                       \
+        value->get_location());                                                \
   }                                                                            \
   return allocate_cell((type)0);
 
 cell_ptr builtin_fn_cvt_to_string(interpreter_c &ci, cell_list_t &list,
                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::STR, ==, 2)
   return allocate_cell(ci.process_cell(list[1], env)->to_string());
 }
 
 cell_ptr builtin_fn_cvt_to_string_lit(interpreter_c &ci, cell_list_t &list,
                                       env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::STR_LIT, ==, 2)
-
-  auto linf = ci.process_cell(list[1], env)->as_list_info();
+  auto target = ci.process_cell(list[1], env);
+  auto &linf = target->read_list_info();
 
   std::string str;
   for (auto i : linf.list) {
@@ -53,67 +51,67 @@ cell_ptr builtin_fn_cvt_to_string_lit(interpreter_c &ci, cell_list_t &list,
 }
 
 cell_ptr builtin_fn_cvt_to_integer(interpreter_c &ci, cell_list_t &list,
-                                   env_c &env){
-    NIBI_LIST_ENFORCE_SIZE(nibi::kw::INT, ==, 2)
-        NIBI_CONVERSION_TO_TYPE(int64_t, std::stoll)}
+                                   env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(int64_t, std::stoll)
+}
 
-cell_ptr builtin_fn_cvt_to_i8(interpreter_c &ci, cell_list_t &list, env_c &env){
-    NIBI_LIST_ENFORCE_SIZE(nibi::kw::I8, ==, 2)
-        NIBI_CONVERSION_TO_TYPE(int8_t, std::stoll)}
+cell_ptr builtin_fn_cvt_to_i8(interpreter_c &ci, cell_list_t &list,
+                              env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(int8_t, std::stoll)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_i16(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::I16, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(int16_t, std::stoll)}
+cell_ptr builtin_fn_cvt_to_i16(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(int16_t, std::stoll)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_i32(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::I32, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(int32_t, std::stoll)}
+cell_ptr builtin_fn_cvt_to_i32(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(int32_t, std::stoll)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_i64(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::I64, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(int64_t, std::stoll)}
+cell_ptr builtin_fn_cvt_to_i64(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(int64_t, std::stoll)
+}
 
-cell_ptr builtin_fn_cvt_to_u8(interpreter_c &ci, cell_list_t &list, env_c &env){
-    NIBI_LIST_ENFORCE_SIZE(nibi::kw::U8, ==, 2)
-        NIBI_CONVERSION_TO_TYPE(uint8_t, std::stoull)}
+cell_ptr builtin_fn_cvt_to_u8(interpreter_c &ci, cell_list_t &list,
+                              env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(uint8_t, std::stoull)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_u16(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::U16, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(uint16_t, std::stoull)}
+cell_ptr builtin_fn_cvt_to_u16(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(uint16_t, std::stoull)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_u32(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::U32, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(uint32_t, std::stoull)}
+cell_ptr builtin_fn_cvt_to_u32(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(uint32_t, std::stoull)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_u64(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::U64, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(uint64_t, std::stoull)}
+cell_ptr builtin_fn_cvt_to_u64(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(uint64_t, std::stoull)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_float(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::FLOAT, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(double, std::stod)}
+cell_ptr builtin_fn_cvt_to_float(interpreter_c &ci, cell_list_t &list,
+                                 env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(double, std::stod)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_f32(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::F32, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(float, std::stof)}
+cell_ptr builtin_fn_cvt_to_f32(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(float, std::stof)
+}
 
-cell_ptr
-    builtin_fn_cvt_to_f64(interpreter_c &ci, cell_list_t &list, env_c &env){
-        NIBI_LIST_ENFORCE_SIZE(nibi::kw::F64, ==, 2)
-            NIBI_CONVERSION_TO_TYPE(double, std::stod)}
+cell_ptr builtin_fn_cvt_to_f64(interpreter_c &ci, cell_list_t &list,
+                               env_c &env) {
+  NIBI_CONVERSION_TO_TYPE(double, std::stod)
+}
 
 cell_ptr
     builtin_fn_cvt_to_char(interpreter_c &ci, cell_list_t &list, env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::CHAR, ==, 2)
-
   auto value = ci.process_cell(list[1], env);
 
   auto result = allocate_cell('\0');
@@ -121,14 +119,14 @@ cell_ptr
   if (value->is_integer()) {
     auto i = value->to_integer();
     result->data.ch = static_cast<char>(i);
-    result->locator = list[0]->locator;
+    result->set_location(list[0]->get_location());
     return result;
   }
 
   if (value->type != cell_type_e::STRING) {
     throw interpreter_c::exception_c(
         "Can not convert non-integer and non-string cell to char",
-        list[0]->locator);
+        list[0]->get_location());
   }
 
   auto str = value->to_string();
@@ -144,7 +142,8 @@ cell_ptr
 
   if (str.size() > 1) {
     throw interpreter_c::exception_c(
-        "String too large to convert into a single char", list[1]->locator);
+        "String too large to convert into a single char",
+        list[1]->get_location());
   }
 
   return allocate_cell(str[0]);
@@ -152,7 +151,6 @@ cell_ptr
 
 cell_ptr builtin_fn_cvt_to_split(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::SPLIT, >=, 2)
   auto value = ci.process_cell(list[1], env);
 
   if (value->type == cell_type_e::LIST) {
@@ -6,6 +6,7 @@
 #include "libnibi/keywords.hpp"
 #include "macros.hpp"
 
+#include <algorithm>
 #include <iterator>
 
 namespace nibi {
@@ -14,33 +15,28 @@ namespace builtins {
 cell_ptr builtin_fn_env_alias(interpreter_c &ci, cell_list_t &list,
                               env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::ALIAS, ==, 3)
-
   auto alias_target = ci.process_cell(list[1], env);
   auto &target_variable_name = list[2]->as_symbol_ref();
 
-  NIBI_VALIDATE_VAR_NAME(target_variable_name, list[2]->locator);
+  NIBI_VALIDATE_VAR_NAME(target_variable_name, list[2]->get_location());
 
   if (list[1]->type == cell_type_e::SYMBOL) {
-    auto &source_variable_name = list[1]->as_symbol_ref();
-    if (source_variable_name == target_variable_name) {
+    if (list[1]->as_symbol_id() == list[2]->as_symbol_id()) {
       throw interpreter_c::exception_c("Cannot alias a variable to itself",
-                                       list[1]->locator);
+                                       list[1]->get_location());
     }
   }
 
   auto cell = allocate_cell(alias_s{alias_target});
-  cell->locator = alias_target->locator;
+  cell->set_location(alias_target->get_location());
 
-  env.set(target_variable_name, cell);
+  env.set(list[2]->as_symbol_id(), cell);
 
-  return allocate_cell(cell_type_e::NIL);
+  return constant_nil();
 }
 
 cell_ptr builtin_fn_env_str_set_at(interpreter_c &ci, cell_list_t &list,
                                    env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::STR_SET_AT, ==, 4)
-
   auto target_cell = ci.process_cell(list[1], env);
   auto target = target_cell->as_string();
 
@@ -52,7 +48,8 @@ cell_ptr builtin_fn_env_str_set_at(interpreter_c &ci, cell_list_t &list,
   }
 
   if (index >= target.size()) {
-    throw interpreter_c::exception_c("Index out of bounds", list[2]->locator);
+    throw interpreter_c::exception_c("Index out of bounds",
+                                     list[2]->get_location());
   }
 
   std::string result =
@@ -66,19 +63,17 @@ cell_ptr builtin_fn_env_str_set_at(interpreter_c &ci, cell_list_t &list,
 cell_ptr builtin_fn_env_assignment(interpreter_c &ci, cell_list_t &list,
                                    env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::ASSIGN, ==, 3)
-
   auto it = list.begin();
   std::advance(it, 1);
 
   if ((*it)->type != cell_type_e::SYMBOL) {
     throw interpreter_c::exception_c(
-        "Expected symbol as first argument to assign", (*it)->locator);
+        "Expected symbol as first argument to assign", (*it)->get_location());
   }
 
   auto &target_variable_name = (*it)->as_symbol_ref();
 
-  NIBI_VALIDATE_VAR_NAME(target_variable_name, (*it)->locator);
+  NIBI_VALIDATE_VAR_NAME(target_variable_name, (*it)->get_location());
 
   auto target_assignment_value = ci.process_cell(list[2], env);
   // ci.process_cell(ci.process_cell(list[2], env), env);
@@ -88,7 +83,7 @@ cell_ptr builtin_fn_env_assignment(interpreter_c &ci, cell_list_t &list,
 
   target_assignment_value = target_assignment_value->clone(env);
 
-  env.set(target_variable_name, target_assignment_value);
+  env.set((*it)->as_symbol_id(), target_assignment_value);
 
   // Return a pointer to the new cell so assignments can be chained
   return target_assignment_value;
@@ -96,9 +91,8 @@ cell_ptr builtin_fn_env_assignment(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_env_set(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::SET, ==, 3)
-
-  auto target_assignment_cell = ci.process_cell(list[1], env);
+  auto target_assignment_cell =
+      env.writable(ci.process_cell(list[1], env), list[1]);
   // ci.process_cell(ci.process_cell(list[1], env), env);
 
   auto target_assignment_value = ci.process_cell(list[2], env);
@@ -111,17 +105,61 @@ cell_ptr builtin_fn_env_set(interpreter_c &ci, cell_list_t &list, env_c &env) {
 }
 
 cell_ptr builtin_fn_env_drop(interpreter_c &ci, cell_list_t &list, env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::DROP, >=, 2)
-
   for (auto it = std::next(list.begin()); it != list.end(); ++it) {
-    if (!env.drop((*it)->as_symbol())) {
+    if (!env.drop((*it)->as_symbol_id())) {
       throw interpreter_c::exception_c("Could not find symbol with name :" +
                                            (*it)->as_symbol(),
-                                       (*it)->locator);
+                                       (*it)->get_location());
+    }
+  }
+  return constant_integer(0);
+}
+
+namespace {
+// Resolve the names that will live in the lambda's own environment
+// to slots so they can be bound by index when the lambda is called.
+// These are the parameters, and any variable assigned at the top
+// level of the body that doesn't collide with them. Assignments
+// nested in `if` / `loop` etc land in their own environments
+void resolve_frame_slots(lambda_info_s &lambda_info) {
+  auto &slots = lambda_info.slot_symbols;
+  if (lambda_info.arg_names.size() == 1 &&
+      lambda_info.arg_names[0] == ":args") {
+    slots.push_back(symbols::intern("$args"));
+  } else {
+    for (auto &name : lambda_info.arg_names) {
+      slots.push_back(symbols::intern(name));
+    }
+  }
+
+  auto add_local = [&](cell_ptr &cell) {
+    if (cell->type != cell_type_e::LIST) {
+      return;
+    }
+    auto &list_info = cell->as_list_info();
+    if (list_info.type != list_types_e::INSTRUCTION ||
+        list_info.list.size() != 3 ||
+        list_info.list[0]->type != cell_type_e::FUNCTION ||
+        list_info.list[0]->as_function_info().name != nibi::kw::ASSIGN ||
+        list_info.list[1]->type != cell_type_e::SYMBOL) {
+      return;
+    }
+    auto id = list_info.list[1]->as_symbol_id();
+    if (std::find(slots.begin(), slots.end(), id) == slots.end()) {
+      slots.push_back(id);
     }
+  };
+
+  auto &body = lambda_info.body->as_list_info();
+  if (body.type == list_types_e::DATA) {
+    for (auto &cell : body.list) {
+      add_local(cell);
+    }
+  } else {
+    add_local(lambda_info.body);
   }
-  return allocate_cell((int64_t)0);
 }
+} // namespace
 
 cell_ptr assemble_anonymous_function(interpreter_c &ci, cell_list_t &list,
                                      env_c &env) {
@@ -133,7 +171,8 @@ cell_ptr assemble_anonymous_function(interpreter_c &ci, cell_list_t &list,
 
   if (function_argument_list.type != list_types_e::DATA) {
     throw interpreter_c::exception_c(
-        "Expected data list `[]` for function arguments", (*it)->locator);
+        "Expected data list `[]` for function arguments",
+        (*it)->get_location());
   }
 
   lambda_info_s lambda_info;
@@ -148,16 +187,19 @@ cell_ptr assemble_anonymous_function(interpreter_c &ci, cell_list_t &list,
   lambda_info.body = (*it)->clone(env, false);
   if (lambda_info.body->type != cell_type_e::LIST) {
     throw interpreter_c::exception_c("Expected list for function body",
-                                     lambda_info.body->locator);
+                                     lambda_info.body->get_location());
   }
 
+  resolve_frame_slots(lambda_info);
+
   function_info_s function_info("anon_fn", execute_suspected_lambda,
                                 function_type_e::LAMBDA_FUNCTION, &env);
+  env.capture();
 
   function_info.lambda = {lambda_info};
 
   auto fn_cell = allocate_cell(function_info);
-  fn_cell->locator = list[0]->locator;
+  fn_cell->set_location(list[0]->get_location());
 
   return std::move(fn_cell);
 }
@@ -167,8 +209,6 @@ cell_ptr builtin_fn_env_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
     return std::move(assemble_anonymous_function(ci, list, env));
   }
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::FN, ==, 4)
-
   auto it = list.begin();
 
   std::advance(it, 1);
@@ -181,7 +221,8 @@ cell_ptr builtin_fn_env_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
   if (function_argument_list.type != list_types_e::DATA) {
     throw interpreter_c::exception_c(
-        "Expected data list `[]` for function arguments", (*it)->locator);
+        "Expected data list `[]` for function arguments",
+        (*it)->get_location());
   }
 
   lambda_info_s lambda_info;
@@ -196,16 +237,19 @@ cell_ptr builtin_fn_env_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
   lambda_info.body = (*it)->clone(env, false);
   if (lambda_info.body->type != cell_type_e::LIST) {
     throw interpreter_c::exception_c("Expected list for function body",
-                                     lambda_info.body->locator);
+                                     lambda_info.body->get_location());
   }
 
+  resolve_frame_slots(lambda_info);
+
   function_info_s function_info(target_function_name, execute_suspected_lambda,
                                 function_type_e::LAMBDA_FUNCTION, &env);
+  env.capture();
 
   function_info.lambda = {lambda_info};
 
   auto fn_cell = allocate_cell(function_info);
-  fn_cell->locator = list[0]->locator;
+  fn_cell->set_location(list[0]->get_location());
 
   // Set the variable
   env.set(target_function_name, fn_cell);
@@ -218,16 +262,16 @@ cell_ptr handle_dict_access(interpreter_c &ci, cell_list_t &list, env_c &env) {
   auto definition = list[0];
 
   if (definition->type == cell_type_e::SYMBOL) {
-    definition = env.get(definition->as_symbol());
+    definition = env.get(definition->as_symbol_id());
   }
 
-  auto fn_info = definition->as_function_info();
+  auto &fn_info = definition->as_function_info();
   auto dict = fn_info.operating_env->get("$data");
 
   // If its just the item then we will load and string the dict
   if (list.size() == 1) {
     auto c = allocate_cell(dict->to_string(true, true));
-    c->locator = list[0]->locator;
+    c->set_location(list[0]->get_location());
     return std::move(c);
   }
 
@@ -235,15 +279,13 @@ cell_ptr handle_dict_access(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
   auto command = list[1]->as_symbol();
 
-  auto &dict_value = dict->as_dict();
-
   if (command == ":keys") {
     list_info_s keys(list_types_e::DATA);
-    for (auto &&dit : dict_value) {
+    for (auto &&dit : dict->read_dict()) {
       keys.list.push_back(allocate_cell(dit.first));
     }
     auto c = allocate_cell(keys);
-    c->locator = list[1]->locator;
+    c->set_location(list[1]->get_location());
     return std::move(c);
   }
 
@@ -251,11 +293,11 @@ cell_ptr handle_dict_access(interpreter_c &ci, cell_list_t &list, env_c &env) {
   // modify the value in the dict directly
   if (command == ":vals") {
     list_info_s vals(list_types_e::DATA);
-    for (auto &&dit : dict_value) {
+    for (auto &&dit : dict->as_dict()) {
       vals.list.push_back(dit.second);
     }
     auto c = allocate_cell(vals);
-    c->locator = list[1]->locator;
+    c->set_location(list[1]->get_location());
     return std::move(c);
   }
 
@@ -280,41 +322,42 @@ cell_ptr handle_dict_access(interpreter_c &ci, cell_list_t &list, env_c &env) {
   if (command == ":let") {
     NIBI_LIST_ENFORCE_SIZE(nibi::kw::DICT, ==, 4)
 
-    auto value = ci.process_cell(list[3], env);
-    value->locator = list[3]->locator;
+    auto value = writable_cell(ci.process_cell(list[3], env));
+    value->set_location(list[3]->get_location());
+    auto &dict_value = dict->as_dict();
     dict_value[key] = value;
     return dict_value[key];
   }
 
   if (command == ":get") {
+    auto &dict_value = dict->as_dict();
     auto dit = dict_value.find(key);
     if (dit == dict_value.end()) {
       throw interpreter_c::exception_c(
-          "Dict does not contain key `" + key + "`", list[2]->locator);
+          "Dict does not contain key `" + key + "`", list[2]->get_location());
     }
 
     return dit->second;
   }
 
   if (command == ":del") {
+    auto &dict_value = dict->own_dict();
     auto dit = dict_value.find(key);
     if (dit == dict_value.end()) {
-      return allocate_cell((int64_t)0);
+      return constant_integer(0);
     }
 
     dict_value.erase(dit);
-    return allocate_cell((int64_t)1);
+    return constant_integer(1);
   }
 
   throw interpreter_c::exception_c("Unknown dict command `" + command + "`",
-                                   list[1]->locator);
+                                   list[1]->get_location());
 }
 
 cell_ptr builtin_fn_dict_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
   // If its size 1 then we make just an empty dict.
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::DICT, >=, 1)
-
   function_info_s function_info("dict", handle_dict_access,
                                 function_type_e::FAUX, new env_c());
 
@@ -324,16 +367,15 @@ cell_ptr builtin_fn_dict_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
   if (list.size() == 1) {
 
     auto cell_actual = allocate_cell(dict_actual);
-    cell_actual->locator = list[0]->locator;
+    cell_actual->set_location(list[0]->get_location());
     function_info.operating_env->set("$flag", allocate_cell(DICT_ID_FLAG));
     function_info.operating_env->set("$data", cell_actual);
     function_info.operating_env->set("$is_dict", allocate_cell((int64_t)1));
     auto fn_actual = allocate_cell(function_info);
-    fn_actual->locator = list[0]->locator;
+    fn_actual->set_location(list[0]->get_location());
     return std::move(fn_actual);
   }
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::DICT, ==, 2)
 
   // If the next item is a symbol we should resolve it
   // because it may hold a list of key value pairs.
@@ -348,7 +390,7 @@ cell_ptr builtin_fn_dict_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
   if (list_info.type != list_types_e::DATA) {
     throw interpreter_c::exception_c("Expected data list `[]` for dict values",
-                                     list[1]->locator);
+                                     list[1]->get_location());
   }
 
   if (list_info.list.size() != 0) {
@@ -359,31 +401,32 @@ cell_ptr builtin_fn_dict_fn(interpreter_c &ci, cell_list_t &list, env_c &env) {
       auto &resolved_list_info = resolved_value->as_list_info();
       if (resolved_list_info.type != list_types_e::DATA) {
         throw interpreter_c::exception_c(
-            "Expected data list `[]` for dict values", value->locator);
+            "Expected data list `[]` for dict values", value->get_location());
       }
       if (resolved_list_info.list.size() != 2) {
         throw interpreter_c::exception_c(
             "Expected list of size 2 for dict values [key value]",
-            value->locator);
+            value->get_location());
       }
       if (resolved_list_info.list[0]->type != cell_type_e::STRING) {
-        throw interpreter_c::exception_c("Expected string for dict key",
-                                         resolved_list_info.list[0]->locator);
+        throw interpreter_c::exception_c(
+            "Expected string for dict key",
+            resolved_list_info.list[0]->get_location());
       }
 
       dict_actual[resolved_list_info.list[0]->to_string()] =
-          ci.process_cell(resolved_list_info.list[1], env);
+          writable_cell(ci.process_cell(resolved_list_info.list[1], env));
     }
   }
 
   auto cell_actual = allocate_cell(dict_actual);
-  cell_actual->locator = list[0]->locator;
+  cell_actual->set_location(list[0]->get_location());
 
   function_info.operating_env->set("$data", cell_actual);
   function_info.operating_env->set("$is_dict", allocate_cell((int64_t)1));
 
   auto fn_actual = allocate_cell(function_info);
-  fn_actual->locator = list[0]->locator;
+  fn_actual->set_location(list[0]->get_location());
   return std::move(fn_actual);
 }
 
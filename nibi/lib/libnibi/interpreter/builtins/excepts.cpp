@@ -7,24 +7,30 @@
 #include "macros.hpp"
 
 #include <iterator>
+#include <optional>
 
 namespace nibi {
 namespace builtins {
 
 namespace {
-cell_ptr handle_thrown_error_in_try(std::string message, cell_ptr recover_cell,
+cell_ptr handle_thrown_error_in_try(cell_ptr error, cell_ptr recover_cell,
                                     interpreter_c &ci, env_c &env) {
-  auto e_cell = allocate_cell(message);
-  env.set(nibi::kw::TERR, e_cell);
+  env.set(nibi::kw::TERR, error);
   auto result = ci.process_cell(recover_cell, env, true);
   env.drop(nibi::kw::TERR);
   return result;
 }
+
+// Marks the attempt of a try for as long as it is being evaluated
+struct attempt_s {
+  attempt_s(interpreter_c &ci) : ci(ci) { ci.enter_try(); }
+  ~attempt_s() { ci.leave_try(); }
+  interpreter_c &ci;
+};
 } // namespace
 
 cell_ptr builtin_fn_except_try(interpreter_c &ci, cell_list_t &list,
                                env_c &env) {
-
   /*
     (try () ())
 
@@ -39,8 +45,6 @@ cell_ptr builtin_fn_except_try(interpreter_c &ci, cell_list_t &list,
 
   */
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::TRY, ==, 3)
-
   auto it = list.begin();
 
   std::advance(it, 1);
@@ -49,29 +53,54 @@ cell_ptr builtin_fn_except_try(interpreter_c &ci, cell_list_t &list,
   std::advance(it, 1);
   auto recover_cell = (*it);
 
-  env_c try_env(&env);
-  ci.push_ctx();
+  // The environment is only needed for recovery, and the
+  // context only if something within the `try` defers to it
+  std::optional<env_c> try_env;
+  auto has_ctx = (form_scope(list) & cell_c::SCOPE_CTX) != 0;
+  if (has_ctx) {
+    try_env.emplace(&env);
+    ci.push_ctx();
+  }
+
+  auto recover = [&](cell_ptr error) {
+    if (!try_env) {
+      try_env.emplace(&env);
+    }
+    return handle_thrown_error_in_try(error, recover_cell, ci, *try_env);
+  };
 
   cell_ptr res{nullptr};
+  cell_ptr error{nullptr};
+  auto depth = ci.get_depth();
 
+  // Errors thrown from statements within the attempt reach here as the
+  // way evaluation completes, and anything else as an exception
   try {
-    // Call execute with the process_data_cell flag set to true
-    // which will allow us to walk over multiple cells and catch on them
-    res = ci.process_cell(attempt_cell, env, true);
+    attempt_s attempt(ci);
+    res = ci.process_statement(attempt_cell, env);
+    if (ci.is_throwing()) {
+      error = ci.take_thrown();
+    }
   } catch (interpreter_c::exception_c &e) {
-    res = handle_thrown_error_in_try(e.what(), recover_cell, ci, try_env);
+    ci.unwind_to(depth);
+    error = allocate_cell(std::string(e.what()));
   } catch (cell_access_exception_c &e) {
-    res = handle_thrown_error_in_try(e.what(), recover_cell, ci, try_env);
+    ci.unwind_to(depth);
+    error = allocate_cell(std::string(e.what()));
   }
 
-  ci.pop_ctx(try_env);
+  if (error) {
+    res = recover(error);
+  }
+
+  if (has_ctx) {
+    ci.pop_ctx(*try_env);
+  }
   return res;
 }
 
 cell_ptr builtin_fn_except_throw(interpreter_c &ci, cell_list_t &list,
                                  env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::THROW, ==, 2)
-
   auto it = list.begin();
 
   std::advance(it, 1);
@@ -79,7 +108,9 @@ cell_ptr builtin_fn_except_throw(interpreter_c &ci, cell_list_t &list,
 
   auto thrown = ci.process_cell(exec_cell, env, true);
 
-  throw interpreter_c::exception_c(thrown->to_string(), list.front()->locator);
+  ci.throw_error(allocate_cell(thrown->to_string()),
+                 list.front()->get_location());
+  return constant_nil();
 }
 
 } // namespace builtins
@@ -39,8 +39,6 @@ namespace builtins {
 cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
                                 env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::EXTERN_CALL, >=, 5);
-
   // Break apart the list and get all the information to make the call
 
   std::optional<std::string> lib_name = std::nullopt;
@@ -62,7 +60,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
         cell_trivial_type_tag_map.end()) {
       std::string err =
           "extern-call: unsupported return type: " + return_type_tag;
-      throw interpreter_c::exception_c(err, list[4]->locator);
+      throw interpreter_c::exception_c(err, list[4]->get_location());
     }
 
     return_type = cell_trivial_type_tag_map[return_type_tag];
@@ -70,7 +68,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
     if (cell_type_to_ffi.find(return_type) == cell_type_to_ffi.end()) {
       std::string err =
           "extern-call: unsupported return type: " + return_type_tag;
-      throw interpreter_c::exception_c(err, list[4]->locator);
+      throw interpreter_c::exception_c(err, list[4]->get_location());
     }
   }
 
@@ -81,7 +79,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
     std::string err = "extern-call: " + std::to_string(arg_types.size()) +
                       " arguments declared, but supplied" +
                       std::to_string(list.size() - 5);
-    throw interpreter_c::exception_c(err, list[0]->locator);
+    throw interpreter_c::exception_c(err, list[0]->get_location());
   }
 
   // Ensure all arg types are supported, and populate a list
@@ -93,14 +91,14 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
     if (it == cell_trivial_type_tag_map.end()) {
       std::string err =
           "extern-call: unsupported type: " + arg_type->as_symbol();
-      throw interpreter_c::exception_c(err, arg_type->locator);
+      throw interpreter_c::exception_c(err, arg_type->get_location());
     }
 
     auto it2 = cell_type_to_ffi.find(it->second);
     if (it2 == cell_type_to_ffi.end()) {
       std::string err =
           "extern-call: unsupported type: " + arg_type->as_symbol();
-      throw interpreter_c::exception_c(err, arg_type->locator);
+      throw interpreter_c::exception_c(err, arg_type->get_location());
     }
     arg_cell_types.push_back(it->second);
   }
@@ -111,7 +109,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
     std::string err = "extern-call: max ffi arguments exceeded: " +
                       std::to_string(arg_cell_types.size()) + " > " +
                       std::to_string(NIBI_FFI_ARG_MAX);
-    throw interpreter_c::exception_c(err, list[0]->locator);
+    throw interpreter_c::exception_c(err, list[0]->get_location());
   }
 
   // Take arguments and process them down to their values
@@ -130,7 +128,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
           "extern-call: argument " + std::to_string(i) + " is of type " +
           cell_type_to_string(args_supplied[i]->type) + " but should be type " +
           cell_type_to_string(arg_cell_types[i]);
-      throw interpreter_c::exception_c(err, list[0]->locator);
+      throw interpreter_c::exception_c(err, list[0]->get_location());
     }
   }
 
@@ -170,7 +168,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
     std::string err = "extern-call: could not open library " +
                       (lib_name.has_value() ? *lib_name : "") + " " +
                       dlerror() + ")";
-    throw interpreter_c::exception_c(err, list[0]->locator);
+    throw interpreter_c::exception_c(err, list[0]->get_location());
   }
 
   void *fn_ptr = dlsym(lib_handle, fn_name.c_str());
@@ -180,7 +178,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
     std::string err =
         "extern-call: could not get handle to function: " + fn_name + " " +
         error;
-    throw interpreter_c::exception_c(err, list[0]->locator);
+    throw interpreter_c::exception_c(err, list[0]->get_location());
   }
 
   // Setup the ffi call
@@ -212,7 +210,7 @@ cell_ptr builtin_fn_extern_call(interpreter_c &ci, cell_list_t &list,
 
     std::string err = "'ffi' call to ffi_prep_cif failed with code: " +
                       std::to_string(status);
-    throw interpreter_c::exception_c(err, list[0]->locator);
+    throw interpreter_c::exception_c(err, list[0]->get_location());
   }
 
   // Perform the call (data will be placed directly into cell->data union
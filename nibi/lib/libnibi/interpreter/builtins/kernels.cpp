@@ -0,0 +1,154 @@
+#include "interpreter/builtins/kernels.hpp"
+
+#include <array>
+#include <utility>
+
+namespace nibi {
+namespace kernels {
+
+namespace {
+
+//! \brief How a numeric type is stored within a cell
+//! \note  Values are operated on in a wide type; U64 and pointers as
+//!        uint64_t, every other integer as int64_t and floating points
+//!        as double
+template <cell_type_e T> struct storage_s;
+
+#define NIBI_KERNEL_STORAGE(___type, ___member, ___wide)                       \
+  template <> struct storage_s<cell_type_e::___type> {                         \
+    using wide_t = ___wide;                                                    \
+    static inline wide_t get(const cell_c::data_u &data) {                     \
+      return static_cast<wide_t>(data.___member);                              \
+    }                                                                          \
+    static inline void set(cell_c::data_u &data, wide_t value) {               \
+      data.___member = static_cast<decltype(data.___member)>(value);           \
+    }                                                                          \
+  };
+
+NIBI_KERNEL_STORAGE(PTR, u64, uint64_t)
+NIBI_KERNEL_STORAGE(U8, u8, int64_t)
+NIBI_KERNEL_STORAGE(U16, u16, int64_t)
+NIBI_KERNEL_STORAGE(U32, u32, int64_t)
+NIBI_KERNEL_STORAGE(U64, u64, uint64_t)
+NIBI_KERNEL_STORAGE(I8, i8, int64_t)
+NIBI_KERNEL_STORAGE(I16, i16, int64_t)
+NIBI_KERNEL_STORAGE(I32, i32, int64_t)
+NIBI_KERNEL_STORAGE(I64, i64, int64_t)
+NIBI_KERNEL_STORAGE(F32, f32, double)
+NIBI_KERNEL_STORAGE(F64, f64, double)
+
+#undef NIBI_KERNEL_STORAGE
+
+//! \brief The numeric types, in the order they index the kernel matrices
+constexpr std::array<cell_type_e, 11> numeric_types = {
+    cell_type_e::PTR, cell_type_e::U8,  cell_type_e::U16, cell_type_e::U32,
+    cell_type_e::U64, cell_type_e::I8,  cell_type_e::I16, cell_type_e::I32,
+    cell_type_e::I64, cell_type_e::F32, cell_type_e::F64};
+
+constexpr std::size_t numeric_count = numeric_types.size();
+
+//! \brief Retrieve the index of a numeric type within the kernel matrices
+constexpr std::size_t index_of(cell_type_e type) {
+  switch (type) {
+  case cell_type_e::PTR:
+    return 0;
+  case cell_type_e::U8:
+    return 1;
+  case cell_type_e::U16:
+    return 2;
+  case cell_type_e::U32:
+    return 3;
+  case cell_type_e::U64:
+    return 4;
+  case cell_type_e::I8:
+    return 5;
+  case cell_type_e::I16:
+    return 6;
+  case cell_type_e::I32:
+    return 7;
+  case cell_type_e::I64:
+    return 8;
+  case cell_type_e::F32:
+    return 9;
+  default:
+    // F64, the only numeric type left
+    return 10;
+  }
+}
+
+//! \brief Arithmetic on an L and an R, computed in the wide type of L
+//!        and stored as the result type of L
+template <cell_type_e L, cell_type_e R>
+result_e arith_kernel(arith_e op, cell_type_e &type, cell_c::data_u &lhs,
+                      const cell_c::data_u &rhs) {
+  using wide_t = typename storage_s<L>::wide_t;
+  wide_t value = storage_s<L>::get(lhs);
+  auto result = apply<wide_t>(
+      op, value, static_cast<wide_t>(storage_s<R>::get(rhs)));
+  if (result != result_e::OK) {
+    return result;
+  }
+  type = result_type(op, L);
+  if (op == arith_e::MOD) {
+    storage_s<L>::set(lhs, value);
+  } else if constexpr (std::is_floating_point_v<wide_t>) {
+    lhs.f64 = value;
+  } else {
+    lhs.i64 = static_cast<int64_t>(value);
+  }
+  return result_e::OK;
+}
+
+//! \brief Comparison of an L and an R, computed in the wide type of L
+template <cell_type_e L, cell_type_e R>
+bool cmp_kernel(cmp_e op, const cell_c::data_u &lhs,
+                const cell_c::data_u &rhs) {
+  using wide_t = typename storage_s<L>::wide_t;
+  return apply<wide_t>(op, storage_s<L>::get(lhs),
+                       static_cast<wide_t>(storage_s<R>::get(rhs)));
+}
+
+using arith_kernel_t = result_e (*)(arith_e, cell_type_e &, cell_c::data_u &,
+                                    const cell_c::data_u &);
+using cmp_kernel_t = bool (*)(cmp_e, const cell_c::data_u &,
+                              const cell_c::data_u &);
+
+template <std::size_t... I>
+constexpr std::array<arith_kernel_t, sizeof...(I)>
+make_arith_matrix(std::index_sequence<I...>) {
+  return {&arith_kernel<numeric_types[I / numeric_count],
+                        numeric_types[I % numeric_count]>...};
+}
+
+template <std::size_t... I>
+constexpr std::array<cmp_kernel_t, sizeof...(I)>
+make_cmp_matrix(std::index_sequence<I...>) {
+  return {&cmp_kernel<numeric_types[I / numeric_count],
+                      numeric_types[I % numeric_count]>...};
+}
+
+//! \brief Every (lhs, rhs) pairing of numeric_types
+using pairings_t = std::make_index_sequence<numeric_count * numeric_count>;
+
+//! \brief Arithmetic kernels indexed by lhs * numeric_count + rhs
+constexpr auto arith_matrix = make_arith_matrix(pairings_t{});
+
+//! \brief Comparison kernels indexed by lhs * numeric_count + rhs
+constexpr auto cmp_matrix = make_cmp_matrix(pairings_t{});
+
+} // namespace
+
+result_e arithmetic_mixed(arith_e op, cell_type_e &type, cell_c::data_u &lhs,
+                          cell_type_e rhs_type, const cell_c::data_u &rhs) {
+  return arith_matrix[index_of(type) * numeric_count + index_of(rhs_type)](
+      op, type, lhs, rhs);
+}
+
+bool compare_mixed(cmp_e op, cell_type_e lhs_type, const cell_c::data_u &lhs,
+                   cell_type_e rhs_type, const cell_c::data_u &rhs) {
+  return cmp_matrix[index_of(lhs_type) * numeric_count + index_of(rhs_type)](
+      op, lhs, rhs);
+}
+
+} // namespace kernels
+} // namespace nibi
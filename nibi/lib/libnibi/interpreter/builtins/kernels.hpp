@@ -0,0 +1,151 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace nibi {
+namespace kernels {
+
+//! \brief Arithmetic operations a kernel can perform
+enum class arith_e : uint8_t { ADD, SUB, MUL, DIV, MOD, POW };
+
+//! \brief Comparisons a kernel can perform
+enum class cmp_e : uint8_t { EQ, NEQ, LT, GT, LTE, GTE, AND, OR };
+
+//! \brief Outcome of an arithmetic kernel
+enum class result_e : uint8_t { OK, DIVISION_BY_ZERO };
+
+//! \brief Check if a type is one the kernels operate on
+inline constexpr bool is_numeric(cell_type_e type) {
+  return static_cast<uint8_t>(type) >= CELL_TYPE_MIN_NUMERIC &&
+         static_cast<uint8_t>(type) <= CELL_TYPE_MAX_NUMERIC;
+}
+
+//! \brief The type an arithmetic operation with a given left hand side
+//!        results in
+//! \note  Modulo keeps the type of the left hand side, everything else
+//!        widens to I64 or F64
+inline constexpr cell_type_e result_type(arith_e op, cell_type_e lhs) {
+  if (op == arith_e::MOD) {
+    return lhs;
+  }
+  return (lhs == cell_type_e::F32 || lhs == cell_type_e::F64)
+             ? cell_type_e::F64
+             : cell_type_e::I64;
+}
+
+//! \brief Operate on two values of the same wide type
+template <typename T>
+inline result_e apply(arith_e op, T &lhs, T rhs) {
+  switch (op) {
+  case arith_e::ADD:
+    lhs += rhs;
+    break;
+  case arith_e::SUB:
+    lhs -= rhs;
+    break;
+  case arith_e::MUL:
+    lhs *= rhs;
+    break;
+  case arith_e::DIV:
+    if (rhs == 0) {
+      return result_e::DIVISION_BY_ZERO;
+    }
+    lhs /= rhs;
+    break;
+  case arith_e::MOD:
+    if constexpr (std::is_floating_point_v<T>) {
+      lhs = std::fmod(lhs, rhs);
+    } else {
+      if (rhs == 0) {
+        return result_e::DIVISION_BY_ZERO;
+      }
+      lhs %= rhs;
+    }
+    break;
+  case arith_e::POW:
+    lhs = static_cast<T>(std::pow(lhs, rhs));
+    break;
+  }
+  return result_e::OK;
+}
+
+//! \brief Compare two values of the same wide type
+template <typename T> inline bool apply(cmp_e op, T lhs, T rhs) {
+  switch (op) {
+  case cmp_e::EQ:
+    return lhs == rhs;
+  case cmp_e::NEQ:
+    return lhs != rhs;
+  case cmp_e::LT:
+    return lhs < rhs;
+  case cmp_e::GT:
+    return lhs > rhs;
+  case cmp_e::LTE:
+    return lhs <= rhs;
+  case cmp_e::GTE:
+    return lhs >= rhs;
+  case cmp_e::AND:
+    return lhs && rhs;
+  case cmp_e::OR:
+    return lhs || rhs;
+  }
+  return false;
+}
+
+//! \brief Perform arithmetic on two numeric values of any type
+//! \note  See arithmetic, which handles the common cases inline
+extern result_e arithmetic_mixed(arith_e op, cell_type_e &type,
+                                 cell_c::data_u &lhs, cell_type_e rhs_type,
+                                 const cell_c::data_u &rhs);
+
+//! \brief Compare two numeric values of any type
+//! \note  See compare, which handles the common cases inline
+extern bool compare_mixed(cmp_e op, cell_type_e lhs_type,
+                          const cell_c::data_u &lhs, cell_type_e rhs_type,
+                          const cell_c::data_u &rhs);
+
+//! \brief Perform arithmetic on two numeric values
+//! \param op The operation
+//! \param type The type of the left hand side, updated to that of the result
+//! \param lhs The left hand side, updated to the result
+//! \param rhs_type The type of the right hand side
+//! \param rhs The right hand side
+//! \note  Both types must be numeric, see is_numeric
+inline result_e arithmetic(arith_e op, cell_type_e &type, cell_c::data_u &lhs,
+                           cell_type_e rhs_type, const cell_c::data_u &rhs) {
+  if (type == cell_type_e::I64 && rhs_type == cell_type_e::I64) {
+    return apply<int64_t>(op, lhs.i64, rhs.i64);
+  }
+  if (type == cell_type_e::F64 && rhs_type == cell_type_e::F64) {
+    return apply<double>(op, lhs.f64, rhs.f64);
+  }
+  return arithmetic_mixed(op, type, lhs, rhs_type, rhs);
+}
+
+//! \brief Compare two numeric values
+//! \note  Both types must be numeric, see is_numeric
+inline bool compare(cmp_e op, cell_type_e lhs_type, const cell_c::data_u &lhs,
+                    cell_type_e rhs_type, const cell_c::data_u &rhs) {
+  if (lhs_type == cell_type_e::I64 && rhs_type == cell_type_e::I64) {
+    return apply<int64_t>(op, lhs.i64, rhs.i64);
+  }
+  if (lhs_type == cell_type_e::F64 && rhs_type == cell_type_e::F64) {
+    return apply<double>(op, lhs.f64, rhs.f64);
+  }
+  return compare_mixed(op, lhs_type, lhs, rhs_type, rhs);
+}
+
+//! \brief Check two strings for equality without copying either
+inline bool strings_equal(const cell_c &lhs, const cell_c &rhs) {
+  const char *l = lhs.data.cstr ? lhs.data.cstr : "";
+  const char *r = rhs.data.cstr ? rhs.data.cstr : "";
+  return std::strcmp(l, r) == 0;
+}
+
+} // namespace kernels
+} // namespace nibi
@@ -13,6 +13,74 @@ namespace builtins {
 //  Lambda Execution taking the form of builtin functions
 // --------------------------------------------------------
 
+namespace {
+
+inline bool is_variadic(lambda_info_s &lambda_info) {
+  return lambda_info.arg_names.size() == 1 &&
+         lambda_info.arg_names[0] == ":args";
+}
+
+// Bind evaluated arguments to the slots that the names of the
+// parameters were resolved to on definition
+void bind_arguments(lambda_info_s &lambda_info, cell_list_t &arguments,
+                    env_c &lambda_env) {
+  if (is_variadic(lambda_info)) {
+    auto &slot = lambda_env.get_slot(0);
+    slot = allocate_cell(
+        list_info_s{list_types_e::DATA, std::move(arguments)});
+    slot->set_location(lambda_info.body->get_location());
+    return;
+  }
+  for (std::size_t i = 0; i < arguments.size(); i++) {
+    lambda_env.get_slot(i) = std::move(arguments[i]);
+  }
+}
+
+} // namespace
+
+cell_list_t evaluate_lambda_arguments(interpreter_c &ci,
+                                      function_info_s &fn_info,
+                                      cell_list_t &list, env_c &env) {
+  auto &lambda_info = *fn_info.lambda;
+  auto it = list.begin();
+
+  cell_list_t arguments;
+
+  if (is_variadic(lambda_info)) {
+    arguments.reserve(list.size() - 1);
+    while (it != list.end() - 1) {
+      std::advance(it, 1);
+
+      if (fn_info.isolate) {
+        arguments.push_back(ci.process_cell((*it), env)->clone(env));
+      } else {
+        arguments.push_back(writable_cell(ci.process_cell((*it), env)));
+      }
+    }
+    return arguments;
+  }
+
+  if (list.size() != lambda_info.arg_names.size() + 1) {
+    throw interpreter_c::exception_c(
+        std::string(nibi::kw::FN) + " instruction expects " +
+            std::to_string(lambda_info.arg_names.size()) + " parameters, got " +
+            std::to_string(list.size() - 1) + ".",
+        list.front()->get_location());
+  }
+
+  arguments.reserve(lambda_info.arg_names.size());
+  for (std::size_t i = 0; i < lambda_info.arg_names.size(); i++) {
+    std::advance(it, 1);
+    NIBI_VALIDATE_VAR_NAME(lambda_info.arg_names[i], (*it)->get_location());
+    if (fn_info.isolate) {
+      arguments.push_back(ci.process_cell((*it), env)->clone(env));
+    } else {
+      arguments.push_back(ci.process_cell((*it), env));
+    }
+  }
+  return arguments;
+}
+
 cell_ptr execute_suspected_lambda(interpreter_c &ci, cell_list_t &list,
                                   env_c &env) {
 
@@ -22,12 +90,11 @@ cell_ptr execute_suspected_lambda(interpreter_c &ci, cell_list_t &list,
 
   // If the first argument is a symbol, then we need to look it up
   if ((*it)->type == cell_type_e::SYMBOL) {
-    auto &target_symbol = (*it)->as_symbol_ref();
-    target_cell = env.get(target_symbol);
+    target_cell = env.get((*it)->as_symbol_id());
     if (!target_cell) {
       throw interpreter_c::exception_c("Symbol not found in environment: " +
                                            (*it)->as_symbol(),
-                                       (*it)->locator);
+                                       (*it)->get_location());
       return nullptr;
     }
   }
@@ -37,72 +104,51 @@ cell_ptr execute_suspected_lambda(interpreter_c &ci, cell_list_t &list,
   if (fn_info.type != function_type_e::LAMBDA_FUNCTION &&
       fn_info.type != function_type_e::FAUX) {
     throw interpreter_c::exception_c("Expected lambda function",
-                                     (*it)->locator);
+                                     (*it)->get_location());
   }
 
-  auto &lambda_info = *fn_info.lambda;
-
-  // Create an environment for the lambda
-  // and populate it with the arguments
-  auto lambda_env = env_c(fn_info.operating_env);
+  auto arguments = evaluate_lambda_arguments(ci, fn_info, list, env);
 
-  auto &map = lambda_env.get_map();
+  // Calls the body makes in tail position are handed back here
+  // rather than made by the body, so each one reuses this frame
+  cell_ptr result;
+  bool yielded{false};
+  while (true) {
+    auto &lambda_info = *target_cell->as_function_info().lambda;
+    lambda_info.calls++;
 
-  if (lambda_info.arg_names.size() == 1 &&
-      lambda_info.arg_names[0] == ":args") {
+    auto lambda_env =
+        env_c(target_cell->as_function_info().operating_env,
+              lambda_info.slot_symbols);
 
-    list_info_s args = {list_types_e::DATA, {}};
+    bind_arguments(lambda_info, arguments, lambda_env);
 
-    while (it != list.end() - 1) {
-      std::advance(it, 1);
+    ci.push_ctx();
 
-      if (fn_info.isolate) {
-        args.list.push_back(ci.process_cell((*it), env)->clone(env));
-      } else {
-        args.list.push_back(ci.process_cell((*it), env));
-      }
-    }
+    result = ci.execute_lambda_body(lambda_info, lambda_env);
 
-    map["$args"] = allocate_cell(args);
-    map["$args"]->locator = lambda_info.body->locator;
+    auto tail_call = ci.take_tail_call();
 
-    // We have a variadic function
-  } else {
-    NIBI_LIST_ENFORCE_SIZE(nibi::kw::FN, ==, lambda_info.arg_names.size() + 1);
+    ci.pop_ctx(lambda_env);
 
-    for (auto &&arg_name : lambda_info.arg_names) {
-      std::advance(it, 1);
-      NIBI_VALIDATE_VAR_NAME(arg_name, (*it)->locator);
-      map[arg_name] = ci.process_cell((*it), env);
-      if (fn_info.isolate) {
-        map[arg_name] = ci.process_cell((*it), env)->clone(env);
-      } else {
-        map[arg_name] = ci.process_cell((*it), env);
-      }
+    if (!tail_call) {
+      break;
     }
-  }
-
-  auto &body = lambda_info.body->as_list_info();
 
-  ci.push_ctx();
-
-  cell_ptr result = ci.process_cell(lambda_info.body, lambda_env, true);
-
-  ci.pop_ctx(lambda_env);
-
-  // Because we have pointers to parametrs stored we don't want the environment
-  // to free them, so we manually remove them here before
-
-  for (auto &&arg_name : lambda_info.arg_names) {
-    map.erase(arg_name);
+    ci.end_yield();
+    target_cell = std::move(tail_call->operation);
+    arguments = std::move(tail_call->arguments);
+    yielded |= tail_call->yielded;
   }
 
-  // We are out of the function, so we can reset the yield value
-  if (ci.is_yielding()) {
-    ci.set_yield_value(nullptr);
+  // We are out of the function, so any yield it made has ended
+  ci.end_yield();
+
+  // A yield would have copied the value of the call it was given
+  if (yielded) {
+    return result->clone(env);
   }
 
-  // Return a copy of the result
   return result;
 }
 
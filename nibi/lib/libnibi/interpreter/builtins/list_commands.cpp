@@ -18,21 +18,20 @@ inline void push_front(cell_list_t &list, cell_ptr &&cell) {
 
 cell_ptr builtin_fn_list_push_front(interpreter_c &ci, cell_list_t &list,
                                     env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::PUSH_FRONT, ==, 3)
-
-  auto value_to_push = std::move(ci.process_cell(list[2], env));
-  value_to_push->locator = list[2]->locator;
+  auto value_to_push = ci.process_cell(list[2], env)->clone(env);
+  value_to_push->set_location(list[2]->get_location());
 
   auto list_to_push_to = std::move(ci.process_cell(list[1], env));
-  list_to_push_to->locator = list[1]->locator;
+  list_to_push_to->set_location(list[1]->get_location());
 
-  auto &list_info = list_to_push_to->as_list_info();
+  auto &list_info = list_to_push_to->own_list_info();
+  list_info.owned = list_info.owned && value_to_push->can_be_owned();
 
   // Clone the target and push it back
 #if CELL_LIST_USE_STD_VECTOR
-  push_front(list_info.list, std::move(value_to_push->clone(env)));
+  push_front(list_info.list, std::move(value_to_push));
 #else
-  list_info.list.push_front(std::move(value_to_push->clone(env)));
+  list_info.list.push_front(std::move(value_to_push));
 #endif
 
   return std::move(list_to_push_to);
@@ -40,30 +39,27 @@ cell_ptr builtin_fn_list_push_front(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_list_push_back(interpreter_c &ci, cell_list_t &list,
                                    env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::PUSH_BACK, ==, 3)
-
-  auto value_to_push = std::move(ci.process_cell(list[2], env));
-  value_to_push->locator = list[2]->locator;
+  auto value_to_push = ci.process_cell(list[2], env)->clone(env);
+  value_to_push->set_location(list[2]->get_location());
 
   auto list_to_push_to = std::move(ci.process_cell(list[1], env));
-  list_to_push_to->locator = list[1]->locator;
+  list_to_push_to->set_location(list[1]->get_location());
 
-  auto &list_info = list_to_push_to->as_list_info();
+  auto &list_info = list_to_push_to->own_list_info();
+  list_info.owned = list_info.owned && value_to_push->can_be_owned();
 
   // Clone the target and push it back
-  list_info.list.push_back(std::move(value_to_push->clone(env)));
+  list_info.list.push_back(std::move(value_to_push));
 
   return std::move(list_to_push_to);
 }
 
 cell_ptr builtin_fn_list_pop_back(interpreter_c &ci, cell_list_t &list,
                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::POP_BACK, ==, 2)
-
   auto target = std::move(ci.process_cell(list[1], env));
-  target->locator = list[1]->locator;
+  target->set_location(list[1]->get_location());
 
-  auto &list_info = target->as_list_info();
+  auto &list_info = target->own_list_info();
 
   if (list_info.list.empty()) {
     return std::move(target);
@@ -76,12 +72,10 @@ cell_ptr builtin_fn_list_pop_back(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_list_pop_front(interpreter_c &ci, cell_list_t &list,
                                    env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::POP_FRONT, ==, 2)
-
   auto target = std::move(ci.process_cell(list[1], env));
-  target->locator = list[1]->locator;
+  target->set_location(list[1]->get_location());
 
-  auto &list_info = target->as_list_info();
+  auto &list_info = target->own_list_info();
 
   if (list_info.list.empty()) {
     return std::move(target);
@@ -99,29 +93,24 @@ cell_ptr builtin_fn_list_pop_front(interpreter_c &ci, cell_list_t &list,
 cell_ptr builtin_fn_list_iter(interpreter_c &ci, cell_list_t &list,
                               env_c &env) {
 
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::ITER, ==, 4)
-
   auto list_to_iterate = std::move(ci.process_cell(list[1], env));
-  list_to_iterate->locator = list[1]->locator;
+  list_to_iterate->set_location(list[1]->get_location());
 
   auto &list_info = list_to_iterate->as_list_info();
 
   auto it = list.begin();
 
   std::advance(it, 2);
-  auto symbol_to_bind = (*it)->as_symbol();
+  auto symbol_to_bind = (*it)->as_symbol_id();
 
   std::advance(it, 1);
   auto ins_to_exec_per_item = (*it);
 
   auto iter_env = env_c(&env);
 
-  auto &current_env_map = iter_env.get_map();
-
   for (auto cell : list_info.list) {
 
-    current_env_map[symbol_to_bind] =
-        std::move(ci.process_cell(cell, iter_env));
+    iter_env.define(symbol_to_bind, ci.process_cell(cell, iter_env));
 
     ci.process_cell(ins_to_exec_per_item, iter_env, true);
   }
@@ -131,8 +120,6 @@ cell_ptr builtin_fn_list_iter(interpreter_c &ci, cell_list_t &list,
 }
 
 cell_ptr builtin_fn_list_at(interpreter_c &ci, cell_list_t &list, env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::AT, ==, 3)
-
   auto requested_idx = std::move(ci.process_cell(list[2], env));
 
   auto target_list = std::move(ci.process_cell(list[1], env));
@@ -147,7 +134,7 @@ cell_ptr builtin_fn_list_at(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
   if (actual_idx_val >= list_info.list.size()) {
     throw interpreter_c::exception_c("Index out of bounds (OOB)",
-                                     list[2]->locator);
+                                     list[2]->get_location());
   }
 
   return std::move(ci.process_cell(list_info.list[actual_idx_val], env));
@@ -155,22 +142,28 @@ cell_ptr builtin_fn_list_at(interpreter_c &ci, cell_list_t &list, env_c &env) {
 
 cell_ptr builtin_fn_list_spawn(interpreter_c &ci, cell_list_t &list,
                                env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::SPAWN, ==, 3)
-
   auto list_size = std::move(ci.process_cell(list[2], env));
 
   if (list_size->as_integer() < 0) {
     auto it = list.begin();
     std::advance(it, 2);
     throw interpreter_c::exception_c("Cannot spawn a list with a negative size",
-                                     (*it)->locator);
+                                     (*it)->get_location());
+  }
+
+  // Each item is a copy of its own, so that the list owns them and
+  // can be assigned without being copied again
+  auto value = ci.process_cell(list[1], env);
+  list_info_s spawned_info(list_types_e::DATA);
+  spawned_info.owned = true;
+  for (int64_t i = 0; i < list_size->as_integer(); i++) {
+    spawned_info.list.push_back(value->clone(env));
+    spawned_info.owned =
+        spawned_info.owned && spawned_info.list.back()->can_be_owned();
   }
 
-  auto spawned = allocate_cell(list_info_s{
-      list_types_e::DATA,
-      cell_list_t(list_size->as_integer(),
-                  std::move(ci.process_cell(list[1], env)->clone(env)))});
-  spawned->locator = list[1]->locator;
+  auto spawned = allocate_cell(std::move(spawned_info));
+  spawned->set_location(list[1]->get_location());
   return std::move(spawned);
 }
 
@@ -13,8 +13,6 @@ namespace builtins {
 
 cell_ptr builtin_fn_memory_new(interpreter_c &ci, cell_list_t &list,
                                env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MEM_NEW, ==, 2)
-
   auto ptr_cell = allocate_cell(cell_type_e::PTR);
   if (list[1]->type == cell_type_e::NIL) {
     return ptr_cell;
@@ -28,8 +26,6 @@ cell_ptr builtin_fn_memory_new(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_memory_del(interpreter_c &ci, cell_list_t &list,
                                env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MEM_DEL, >=, 2)
-
   auto ptr = allocate_cell(cell_type_e::PTR);
   for (size_t i = 1; i < list.size(); i++) {
     ptr = ci.process_cell(list[i], env);
@@ -46,26 +42,24 @@ cell_ptr builtin_fn_memory_del(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_memory_is_set(interpreter_c &ci, cell_list_t &list,
                                   env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MEM_IS_SET, ==, 2)
   auto ptr = ci.process_cell(list[1], env);
   if (ptr->type != cell_type_e::PTR) {
     throw interpreter_c::exception_c("Cell does not contain a pointer",
-                                     list[1]->locator);
+                                     list[1]->get_location());
   }
-  return allocate_cell((int64_t)(ptr->data.ptr != nullptr));
+  return constant_integer(ptr->data.ptr != nullptr);
 }
 
 cell_ptr copy_cell_into_memory(interpreter_c &ci, cell_ptr &source,
                                cell_ptr &dest) {
-
   if (static_cast<uint8_t>(source->type) > CELL_TYPE_MAX_TRIVIAL) {
     throw interpreter_c::exception_c(
-        "Can not copy non-trivial cell into memory", source->locator);
+        "Can not copy non-trivial cell into memory", source->get_location());
   }
 
   if (source->type == cell_type_e::NIL) {
     throw interpreter_c::exception_c("Can not copy NIL cell into memory",
-                                     source->locator);
+                                     source->get_location());
   }
 
   if (dest->data.ptr != nullptr) {
@@ -129,7 +123,7 @@ cell_ptr copy_cell_into_memory(interpreter_c &ci, cell_ptr &source,
   default:
     throw interpreter_c::exception_c(
         "Attempt to copy unhandled non-trivial cell into memory",
-        source->locator);
+        source->get_location());
     break;
   }
   return dest;
@@ -137,7 +131,6 @@ cell_ptr copy_cell_into_memory(interpreter_c &ci, cell_ptr &source,
 
 cell_ptr copy_memory(interpreter_c &ci, cell_ptr &source, cell_ptr &dest,
                      uint64_t size) {
-
   if (dest->data.ptr != nullptr) {
     free(dest->data.ptr);
   }
@@ -149,13 +142,11 @@ cell_ptr copy_memory(interpreter_c &ci, cell_ptr &source, cell_ptr &dest,
 
 cell_ptr builtin_fn_memory_cpy(interpreter_c &ci, cell_list_t &list,
                                env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MEM_CPY, >=, 3)
-
   auto dest = ci.process_cell(list[2], env);
 
   if (dest->type != cell_type_e::PTR) {
     throw interpreter_c::exception_c("Destination cell must be a pointer",
-                                     list[2]->locator);
+                                     list[2]->get_location());
   }
 
   auto source = ci.process_cell(list[1], env);
@@ -170,7 +161,7 @@ cell_ptr builtin_fn_memory_cpy(interpreter_c &ci, cell_list_t &list,
 
   if (!size_bytes->is_integer()) {
     throw interpreter_c::exception_c("Expected size parameter to be an integer",
-                                     list[3]->locator);
+                                     list[3]->get_location());
   }
 
   return copy_memory(ci, source, dest, size_bytes->data.u64);
@@ -178,21 +169,19 @@ cell_ptr builtin_fn_memory_cpy(interpreter_c &ci, cell_list_t &list,
 
 cell_ptr builtin_fn_memory_load(interpreter_c &ci, cell_list_t &list,
                                 env_c &env) {
-  NIBI_LIST_ENFORCE_SIZE(nibi::kw::MEM_LOAD, ==, 3)
-
   auto suspected_tag = list[1]->as_symbol();
 
   auto tcm = cell_trivial_type_tag_map.find(suspected_tag);
   if (tcm == cell_trivial_type_tag_map.end()) {
     throw interpreter_c::exception_c(
-        "Expected parameter to be a trivial type tag", list[1]->locator);
+        "Expected parameter to be a trivial type tag", list[1]->get_location());
   }
 
   auto dest = ci.process_cell(list[2], env);
 
   if (dest->data.ptr == nullptr) {
     throw interpreter_c::exception_c("Attempt to load from unallocated pointer",
-                                     list[2]->locator);
+                                     list[2]->get_location());
   }
 
   auto new_cell = allocate_cell(tcm->second);
@@ -236,7 +225,7 @@ cell_ptr builtin_fn_memory_load(interpreter_c &ci, cell_list_t &list,
   default:
     throw interpreter_c::exception_c(
         "Attempted to load unhandled type directly from memory",
-        list[1]->locator);
+        list[1]->get_location());
     break;
   }
 
@@ -0,0 +1,51 @@
+#include "eval_cache.hpp"
+
+namespace nibi {
+
+std::shared_ptr<eval_cache_c::program_s>
+eval_cache_c::find(location_s location, const std::string &source) {
+  auto it = index_.find(key_s{location.get_packed(), source});
+  if (it == index_.end()) {
+    stats_.misses++;
+    return nullptr;
+  }
+  stats_.hits++;
+  order_.splice(order_.begin(), order_, it->second);
+  return it->second->program;
+}
+
+std::shared_ptr<eval_cache_c::program_s>
+eval_cache_c::insert(location_s location, std::string source,
+                     std::vector<cell_ptr> instructions) {
+  auto program = std::make_shared<program_s>();
+  program->lowered.resize(instructions.size());
+  program->instructions = std::move(instructions);
+
+  if (!capacity_) {
+    return program;
+  }
+
+  key_s key{location.get_packed(), std::move(source)};
+  auto existing = index_.find(key);
+  if (existing != index_.end()) {
+    order_.erase(existing->second);
+    index_.erase(existing);
+  }
+
+  while (order_.size() >= capacity_) {
+    index_.erase(order_.back().key);
+    order_.pop_back();
+    stats_.evictions++;
+  }
+
+  order_.push_front(entry_s{key, program});
+  index_.emplace(std::move(key), order_.begin());
+  return program;
+}
+
+void eval_cache_c::clear() {
+  index_.clear();
+  order_.clear();
+}
+
+} // namespace nibi
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+#include "libnibi/source.hpp"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nibi {
+
+//! \brief A least recently used cache of the instructions that source
+//!        handed to eval was parsed into, so that evaluating the same
+//!        source again doesn't lex and parse it again
+//! \note  Entries are keyed by the source and the location of the eval
+//!        that parsed it, as the instructions carry locations relative
+//!        to the eval
+class eval_cache_c {
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+  //! \brief The instructions parsed from a source
+  struct program_s {
+    std::vector<cell_ptr> instructions;
+    std::vector<std::optional<std::shared_ptr<vm::chunk_c>>> lowered;
+    bool in_place{false}; // The instructions hold no data lists
+  };
+
+  //! \brief Counters kept by the cache
+  struct stats_s {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+  };
+
+  //! \brief Construct the cache
+  //! \param capacity The number of programs kept before the least
+  //!        recently used is evicted
+  eval_cache_c(std::size_t capacity = DEFAULT_CAPACITY)
+      : capacity_(capacity) {}
+
+  //! \brief Find the program parsed from a source, counting a hit or a
+  //!        miss and marking it as the most recently used
+  //! \param location The location of the eval
+  //! \param source The source given to the eval
+  //! \return The program, or nullptr if it isn't cached
+  //! \note  Programs are shared so that they outlive their eviction
+  //!        while they are executing
+  std::shared_ptr<program_s> find(location_s location,
+                                  const std::string &source);
+
+  //! \brief Cache the program parsed from a source
+  //! \param location The location of the eval
+  //! \param source The source given to the eval
+  //! \param instructions The instructions the source was parsed into
+  //! \return The cached program
+  std::shared_ptr<program_s> insert(location_s location, std::string source,
+                                    std::vector<cell_ptr> instructions);
+
+  //! \brief Drop every cached program, keeping the counters
+  void clear();
+
+  //! \brief Get the number of programs cached
+  std::size_t size() const { return order_.size(); }
+
+  //! \brief Get the number of programs kept before evicting
+  std::size_t get_capacity() const { return capacity_; }
+
+  //! \brief Get the counters kept by the cache
+  const stats_s &get_stats() const { return stats_; }
+
+private:
+  struct key_s {
+    uint64_t location;
+    std::string source;
+    bool operator==(const key_s &other) const {
+      return location == other.location && source == other.source;
+    }
+  };
+
+  struct key_hash_s {
+    std::size_t operator()(const key_s &key) const {
+      return std::hash<std::string>{}(key.source) ^
+             std::hash<uint64_t>{}(key.location) * 31;
+    }
+  };
+
+  struct entry_s {
+    key_s key;
+    std::shared_ptr<program_s> program;
+  };
+
+  std::size_t capacity_;
+  stats_s stats_;
+
+  // Most recently used first
+  std::list<entry_s> order_;
+  std::unordered_map<key_s, std::list<entry_s>::iterator, key_hash_s> index_;
+};
+
+} // namespace nibi
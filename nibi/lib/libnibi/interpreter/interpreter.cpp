@@ -1,7 +1,13 @@
 #include "interpreter.hpp"
 
+#include "libnibi/collector.hpp"
+#include "libnibi/interpreter/builtins/builtins.hpp"
+#include "libnibi/interpreter/vm/compiler.hpp"
+#include "libnibi/interpreter/vm/vm.hpp"
+#include "libnibi/keywords.hpp"
 #include "libnibi/platform.hpp"
 #include "libnibi/rang.hpp"
+#include "libnibi/runtime.hpp"
 #include <thread>
 
 #if PROFILE_INTERPRETER
@@ -17,7 +23,7 @@
   } catch (cell_access_exception_c & error) {                                  \
     halt_with_error(error_c(error.get_source_location(), error.what()));       \
   } catch (std::exception & error) {                                           \
-    halt_with_error(error_c(cell->locator, error.what()));                     \
+    halt_with_error(error_c(cell->get_location(), error.what()));              \
   }
 
 namespace nibi {
@@ -25,7 +31,7 @@ namespace nibi {
 interpreter_c::interpreter_c(env_c &env, source_manager_c &source_manager)
     : interpreter_env(env), source_manager_(source_manager),
       modules_(source_manager, *this) {
-  stored_cells_.last_result = allocate_cell(cell_type_e::NIL);
+  stored_cells_.last_result = constant_nil();
   push_ctx();
 }
 
@@ -48,30 +54,311 @@ interpreter_c::~interpreter_c() {
 #endif
 }
 
-void interpreter_c::terminate() {
-  flags_.terminate = true;
-  return;
+void interpreter_c::terminate() { completion_ = completion_e::TERMINATE; }
+
+cell_ptr interpreter_c::get_completion_value() {
+  return is_yielding() ? stored_cells_.yield_value : constant_nil();
+}
+
+void interpreter_c::throw_error(cell_ptr error, location_s location) {
+  // Without a try to take it the error halts, and is raised
+  // where it is thrown so the trace shows where that was
+  if (!try_depth_) {
+    throw exception_c(error->to_string(), location);
+  }
+  stored_cells_.thrown = error;
+  stored_cells_.thrown_location = location;
+  if (completion_ == completion_e::NORMAL) {
+    completion_ = completion_e::THROW;
+  }
+}
+
+cell_ptr interpreter_c::take_thrown() {
+  if (completion_ == completion_e::THROW) {
+    completion_ = completion_e::NORMAL;
+  }
+  return std::exchange(stored_cells_.thrown, nullptr);
+}
+
+void interpreter_c::unwind_to(depth_s depth) {
+  while (call_stack_.size() > depth.calls) {
+    call_stack_.pop();
+  }
+  while (ctxs_.size() > depth.ctxs) {
+    ctxs_.pop();
+  }
+}
+
+void interpreter_c::trace_calls(std::size_t depth, const cell_list_t &calls) {
+  cell_list_t within;
+  while (call_stack_.size() > depth) {
+    within.push_back(call_stack_.top());
+    call_stack_.pop();
+  }
+  for (auto &call : calls) {
+    call_stack_.push(call);
+  }
+  for (auto it = within.rbegin(); it != within.rend(); ++it) {
+    call_stack_.push(*it);
+  }
+}
+
+void interpreter_c::raise_thrown() {
+  auto location = stored_cells_.thrown_location;
+  throw exception_c(take_thrown()->to_string(), location);
 }
 
 void interpreter_c::instruction_ind(cell_ptr &cell) {
   EXECUTE_AND_CATCH({
-    stored_cells_.last_result = handle_list_cell(cell, interpreter_env, false);
+    if (auto chunk = lower(cell)) {
+      stored_cells_.last_result = vm::execute(*this, *chunk, interpreter_env);
+    } else {
+      stored_cells_.last_result =
+          handle_list_cell(cell, interpreter_env, false);
+    }
+
+    // Yields outside of any body only end the instruction they're in
+    if (is_yielding()) {
+      end_yield();
+    }
   });
 }
 
+cell_ptr interpreter_c::execute(cell_ptr &cell, env_c &env) {
+  if (auto chunk = lower(cell)) {
+    return vm::execute(*this, *chunk, env);
+  }
+  return process_cell(cell, env);
+}
+
+cell_ptr
+interpreter_c::execute(cell_ptr &cell, env_c &env,
+                       std::optional<std::shared_ptr<vm::chunk_c>> &lowered) {
+  if (!lowered) {
+    lowered = lower(cell);
+  }
+
+  // Hold onto the chunk in case it is dropped while executing
+  if (auto chunk = *lowered) {
+    return vm::execute(*this, *chunk, env);
+  }
+  return process_cell(cell, env);
+}
+
+cell_ptr interpreter_c::execute_lambda_body(lambda_info_s &lambda,
+                                            env_c &env) {
+  if (global_runtime_options.bytecode) {
+    // Hold onto the chunk in case the lambda is redefined while
+    // its body is executing
+    if (auto chunk = vm::compiler_c::lower_lambda(lambda)) {
+      if (global_runtime_options.jit && lambda.calls >= jit::HOT_CALLS) {
+        if (auto result = execute_native(lambda, *chunk, env)) {
+          return *result;
+        }
+      }
+      if (lambda.compiled) {
+        return lambda.compiled(*this, *chunk, env);
+      }
+      return vm::execute(*this, *chunk, env);
+    }
+  }
+  return process_body(lambda.body, env, true);
+}
+
+// Compiled code is specialized on the types of the arguments of the
+// call that compiled it, and bails out to the bytecode for anything
+// else. Code that keeps bailing out is dropped
+std::optional<cell_ptr> interpreter_c::execute_native(lambda_info_s &lambda,
+                                                      vm::chunk_c &chunk,
+                                                      env_c &env) {
+  if (!lambda.native_attempted) {
+    lambda.native_attempted = true;
+    lambda.native = jit::compile(chunk, lambda, env);
+    if (lambda.native) {
+      jit_stats_.compiled++;
+    }
+  }
+
+  auto native = lambda.native;
+  if (!native || is_completing()) {
+    return std::nullopt;
+  }
+
+  if (auto result = native->run(*this, env)) {
+    return result;
+  }
+
+  jit_stats_.bailouts++;
+  if (native->get_bailouts() >= jit::MAX_BAILOUTS) {
+    lambda.native = nullptr;
+    jit_stats_.deoptimized++;
+  }
+  return std::nullopt;
+}
+
+bool interpreter_c::can_tail_call(cell_ptr &cell, cell_ptr &operation,
+                                  env_c &env) {
+  if (!operation || operation->type != cell_type_e::FUNCTION ||
+      operation->as_function_info().type != function_type_e::LAMBDA_FUNCTION) {
+    return false;
+  }
+  if (!ctxs_.empty() && !ctxs_.top().deferred.empty()) {
+    return false;
+  }
+
+  // The frame is gone before the call is made, so it must stay in
+  // place once a lambda that refers to it has been defined, however
+  // that lambda is reached. Those defined by the arguments of the call
+  // are found by the call's need for its environment
+  auto *frame = env.get_frame();
+  if (!frame) {
+    return true;
+  }
+  return !frame->is_captured() &&
+         !(builtins::call_scope(cell) & cell_c::SCOPE_ENV);
+}
+
+void interpreter_c::tail_call(cell_ptr &cell, cell_ptr &operation,
+                              env_c &env, bool yielded) {
+  auto arguments = builtins::evaluate_lambda_arguments(
+      *this, operation->as_function_info(), cell->as_list(), env);
+  if (is_completing()) {
+    return;
+  }
+  tail_call_ = tail_call_s{operation, std::move(arguments), yielded};
+
+  // Nothing reads the value, it only unwinds the body
+  yield(constant_nil());
+}
+
+// Walks a lambda body as process_cell would, but makes the calls in
+// tail position, and those whose value is yielded, as tail calls.
+// Everything reached from the body through data lists and the branches
+// of an `if` leaves the body when it yields, while only the last of
+// those is the value of the body when tail is set
+cell_ptr interpreter_c::process_body(cell_ptr &cell, env_c &env, bool tail) {
+  if (cell->type != cell_type_e::LIST || is_terminating()) {
+    return process_cell(cell, env, true);
+  }
+
+  auto &list_info = cell->as_list_info();
+  auto &list = list_info.list;
+  if (list.empty()) {
+    return process_cell(cell, env, true);
+  }
+
+  if (list_info.type == list_types_e::DATA) {
+    cell_ptr last_result = constant_nil();
+    for (std::size_t i = 0; i < list.size(); i++) {
+      auto &item = list[i];
+      if (item->type == cell_type_e::LIST &&
+          item->as_list_info().type == list_types_e::INSTRUCTION) {
+        last_result = process_body(item, env, tail && i == list.size() - 1);
+      } else {
+        last_result = process_cell(item, env);
+      }
+      if (is_completing()) {
+        return get_completion_value();
+      }
+    }
+    return last_result;
+  }
+
+  if (list_info.type != list_types_e::INSTRUCTION) {
+    return process_cell(cell, env, true);
+  }
+
+  auto &head = list.front();
+  if (head->type == cell_type_e::FUNCTION &&
+      head->as_function_info().type == function_type_e::BUILTIN_CPP_FUNCTION) {
+    auto &fn_info = head->as_function_info();
+    auto &name = fn_info.name;
+    // An `if` given the wrong number of arguments is left to the call
+    // to report, which only checks those that were not verified
+    if (name == kw::IF && ((cell->flags & cell_c::VERIFIED) ||
+                           fn_info.arity.accepts(list.size() - 1))) {
+      std::optional<env_c> scope_env;
+      auto &if_env = (builtins::form_scope(list) & cell_c::SCOPE_ENV)
+                         ? scope_env.emplace(&env)
+                         : env;
+      if (auto branch = builtins::select_if_branch(*this, list, if_env)) {
+        return process_body(branch, if_env, tail);
+      }
+      return get_last_result();
+    }
+    if (name == kw::YIELD && list.size() == 2 &&
+        try_tail_call(list[1], env, true)) {
+      return get_completion_value();
+    }
+  } else if (tail && try_tail_call(cell, env, false)) {
+    return get_completion_value();
+  }
+
+  return process_statement(cell, env);
+}
+
+bool interpreter_c::try_tail_call(cell_ptr &cell, env_c &env, bool yielded) {
+  if (cell->type != cell_type_e::LIST) {
+    return false;
+  }
+  auto &list_info = cell->as_list_info();
+  if (list_info.type != list_types_e::INSTRUCTION || list_info.list.empty() ||
+      list_info.list.front()->type != cell_type_e::SYMBOL) {
+    return false;
+  }
+  auto operation = env.get(list_info.list.front()->as_symbol_id(),
+                           list_info.head_cache);
+  if (!can_tail_call(cell, operation, env)) {
+    return false;
+  }
+  tail_call(cell, operation, env, yielded);
+  return true;
+}
+
+std::shared_ptr<vm::chunk_c> interpreter_c::lower(cell_ptr &cell) {
+  // Instructions that are executed once are only worth lowering
+  // if they contain a loop that the machine can run natively
+  if (!global_runtime_options.bytecode ||
+      !vm::compiler_c::is_worth_lowering(cell)) {
+    return nullptr;
+  }
+  return vm::compiler_c::compile(cell, false);
+}
+
 void interpreter_c::pop_ctx(env_c &env) {
   if (ctxs_.empty()) {
     return;
   }
-  auto current = ctxs_.top();
-  for (auto cell : current.deferred) {
+  // The context stays open while they run, so that anything they
+  // defer is discarded along with it rather than reaching its parent
+  auto deferred = std::move(ctxs_.top().deferred);
+  if (deferred.empty()) {
+    ctxs_.pop();
+    return;
+  }
+
+  // They run in full when the context is left by a yield or a throw,
+  // which carries on once they have. Any yield of their own ends with
+  // them
+  auto leaving = completion_;
+  auto stored = stored_cells_;
+  for (auto &cell : deferred) {
     if (!cell) {
       continue;
     }
 
+    end_yield();
+    if (is_throwing()) {
+      take_thrown();
+    }
     EXECUTE_AND_CATCH(
         { stored_cells_.last_result = process_cell(cell, env, true); });
   }
+  if (!is_terminating()) {
+    completion_ = leaving;
+    stored.last_result = stored_cells_.last_result;
+    stored_cells_ = std::move(stored);
+  }
   ctxs_.pop();
 }
 
@@ -80,7 +367,7 @@ void interpreter_c::halt_with_error(error_c error) {
   // If the interpreter is externally terminated we
   // don't want to shut everything down, and we don't
   // care about the halt
-  if (flags_.terminate) {
+  if (is_terminating()) {
     return;
   }
 
@@ -104,10 +391,10 @@ void interpreter_c::halt_with_error(error_c error) {
     std::cout << ">>> " << rang::fg::cyan << top_cell->to_string(true, true)
               << rang::fg::reset;
 
-    if (top_cell->locator) {
-      std::cout << " in " << top_cell->locator->get_source_name() << ":("
-                << top_cell->locator->get_line() << ":"
-                << top_cell->locator->get_column() << ")";
+    if (top_cell->get_location()) {
+      std::cout << " in " << top_cell->get_location().get_source_name() << ":("
+                << top_cell->get_location().get_line() << ":"
+                << top_cell->get_location().get_column() << ")";
     } else {
       std::cout << " in <location unknown>";
     }
@@ -123,12 +410,8 @@ void interpreter_c::halt_with_error(error_c error) {
 cell_ptr interpreter_c::process_cell(cell_ptr cell, env_c &env,
                                      const bool process_data_list) {
 
-  if (stored_cells_.yield_value) {
-    return stored_cells_.yield_value;
-  }
-
-  if (!cell || flags_.terminate) {
-    return allocate_cell(cell_type_e::NIL);
+  if (!cell) {
+    return constant_nil();
   }
 
   switch (cell->type) {
@@ -139,12 +422,12 @@ cell_ptr interpreter_c::process_cell(cell_ptr cell, env_c &env,
     return cell->get_alias();
   case cell_type_e::SYMBOL: {
     // Load the symbol from the environment
-    auto loaded_cell = env.get(cell->as_symbol());
+    auto loaded_cell = env.read(*cell);
     if (!loaded_cell) {
 
       const std::string error =
           "Symbol not found in environment: " + cell->as_symbol();
-      throw exception_c(error, cell->locator);
+      throw exception_c(error, cell->get_location());
       return nullptr;
     }
 
@@ -163,7 +446,7 @@ cell_ptr interpreter_c::process_cell(cell_ptr cell, env_c &env,
 inline bool considered_private(cell_ptr &cell) {
   switch (cell->type) {
   case cell_type_e::SYMBOL: {
-    return cell->as_symbol().starts_with("_");
+    return symbols::is_private(cell->as_symbol_id());
   }
   case cell_type_e::FUNCTION: {
     return cell->as_function_info().name.starts_with("_");
@@ -178,8 +461,12 @@ inline bool considered_private(cell_ptr &cell) {
 
 inline cell_ptr interpreter_c::handle_list_cell(cell_ptr &cell, env_c &env,
                                                 bool process_data_list) {
-  if (!cell || flags_.terminate) {
-    return allocate_cell(cell_type_e::NIL);
+  auto statement = std::exchange(statement_, false);
+
+  // Lists are the only cells whose evaluation does anything, so
+  // evaluation that's being cut short stops at them
+  if (completion_ != completion_e::NORMAL) {
+    return get_completion_value();
   }
 
   auto &list = cell->as_list();
@@ -190,11 +477,11 @@ inline cell_ptr interpreter_c::handle_list_cell(cell_ptr &cell, env_c &env,
   switch (cell->as_list_info().type) {
   case list_types_e::DATA: {
     if (process_data_list) {
-      cell_ptr last_result = allocate_cell(cell_type_e::NIL);
+      cell_ptr last_result = constant_nil();
       for (auto &list_cell : list) {
-        last_result = process_cell(list_cell, env);
-        if (this->is_yielding()) {
-          return stored_cells_.yield_value;
+        last_result = process_statement(list_cell, env, false);
+        if (is_completing()) {
+          return get_completion_value();
         }
       }
       return std::move(last_result);
@@ -206,25 +493,25 @@ inline cell_ptr interpreter_c::handle_list_cell(cell_ptr &cell, env_c &env,
     // and directing us through environments to a final cell value
     auto it = list.begin();
     auto *current_env = &env;
-    cell_ptr result = allocate_cell(cell_type_e::NIL);
+    cell_ptr result = constant_nil();
     for (std::size_t i = 0; i < list.size() - 1; i++) {
       result = process_cell(*it, *current_env);
       if (result->type == cell_type_e::ENVIRONMENT) {
         current_env = result->as_environment_info().env.get();
         if (considered_private(result) && i != 0) {
-          halt_with_error(error_c(cell->locator,
+          halt_with_error(error_c(cell->get_location(),
                                   "Private members can only be accessed "
                                   "from the root of an access list"));
         }
         std::advance(it, 1);
         continue;
       }
-      halt_with_error(error_c(cell->locator,
+      halt_with_error(error_c(cell->get_location(),
                               "Each member up-to the end of an access list "
                               "must be an environment"));
     }
     if (considered_private((*it))) {
-      halt_with_error(error_c(cell->locator,
+      halt_with_error(error_c(cell->get_location(),
                               "Private members can only be accessed from "
                               "the root of an access list"));
     }
@@ -240,7 +527,13 @@ inline cell_ptr interpreter_c::handle_list_cell(cell_ptr &cell, env_c &env,
 
       // If the operation is a symbol then we need to
       // look it up in the environment
-      operation = process_cell(std::move(operation), env);
+      operation = env.get(operation->as_symbol_id(),
+                          cell->as_list_info().head_cache);
+      if (!operation) {
+        throw exception_c("Symbol not found in environment: " +
+                              list.front()->as_symbol(),
+                          list.front()->get_location());
+      }
     }
 
     if (operation->type == cell_type_e::ALIAS) {
@@ -255,47 +548,86 @@ inline cell_ptr interpreter_c::handle_list_cell(cell_ptr &cell, env_c &env,
       list.front() = operation;
     }
 
-    auto fn_info = operation->as_function_info();
-
-    if (call_stack_.size() >= MAX_CALL_DEPTH) {
-      throw exception_c("Maximum recursion depth reached", cell->locator);
+    auto result = call(cell, operation, env);
+    if (completion_ == completion_e::THROW && !statement) {
+      raise_thrown();
     }
+    return result;
+  }
+  }
 
-    call_stack_.push(list.front());
+  if (is_terminating()) {
+    return constant_nil();
+  }
+  // If we get here then we have a list that is not a function
+  // so we return it as is
+  return std::move(cell);
+}
 
-#if PROFILE_INTERPRETER
-    if (fn_call_data_.find(fn_info.name) == fn_call_data_.end()) {
-      fn_call_data_[fn_info.name] = {0, 0};
-    }
-    auto start = std::chrono::high_resolution_clock::now();
-    auto value = fn_info.fn(*this, list, env);
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration =
-        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-            .count();
-    auto &t = fn_call_data_[fn_info.name];
-    t.time += duration;
-    t.calls++;
+cell_ptr interpreter_c::call(cell_ptr &cell, cell_ptr &operation,
+                             env_c &env) {
+  auto &list = cell->as_list();
+  auto &fn_info = operation->as_function_info();
 
-    call_stack_.pop();
-    return value;
-#else
-    // All functions point to a `cell_fn_t`, even lambda functions
-    // so we can just call the function and return the result
-    auto value = fn_info.fn(*this, list, env);
+  if (call_stack_.size() >= MAX_CALL_DEPTH) {
+    throw exception_c("Maximum recursion depth reached", cell->get_location());
+  }
 
-    call_stack_.pop();
-    return std::move(value);
-#endif
+  // Instructions verified as they were read are known to be given
+  // what they take, anything else is checked here before the call
+  if (!(cell->flags & cell_c::VERIFIED) &&
+      !fn_info.arity.accepts(list.size() - 1)) {
+    throw exception_c(fn_info.arity_error(list.size() - 1),
+                      list.front()->get_location());
   }
+
+  call_stack_.push(list.front());
+
+  // Everything in use is held by a reference between calls,
+  // so this is where containers held only by cycles are freed
+  if (collector::is_due()) {
+    collector::collect();
   }
 
-  if (this->flags_.terminate) {
-    return allocate_cell(cell_type_e::NIL);
+#if PROFILE_INTERPRETER
+  if (fn_call_data_.find(fn_info.name) == fn_call_data_.end()) {
+    fn_call_data_[fn_info.name] = {0, 0};
   }
-  // If we get here then we have a list that is not a function
-  // so we return it as is
-  return std::move(cell);
+  auto start = std::chrono::high_resolution_clock::now();
+  auto value = fn_info.eager ? call_eager(fn_info.eager, list, env)
+                             : fn_info.fn(*this, list, env);
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count();
+  auto &t = fn_call_data_[fn_info.name];
+  t.time += duration;
+  t.calls++;
+
+  call_stack_.pop();
+  return value;
+#else
+  // All functions point to a `cell_fn_t`, even lambda functions
+  // so we can just call the function and return the result. Builtins
+  // that take their arguments evaluated are given them directly
+  auto value = fn_info.eager ? call_eager(fn_info.eager, list, env)
+                             : fn_info.fn(*this, list, env);
+
+  call_stack_.pop();
+  return std::move(value);
+#endif
+}
+
+cell_ptr interpreter_c::call_eager(cell_eager_fn_t fn, cell_list_t &list,
+                                   env_c &env) {
+  operand_frame_c frame(*this);
+  for (auto it = list.begin() + 1; it != list.end(); ++it) {
+    frame.push(process_cell(*it, env));
+    if (is_completing()) {
+      return get_completion_value();
+    }
+  }
+  return fn(*this, frame.args(), env);
 }
 
 void interpreter_c::load_module(cell_ptr &module_name) {
@@ -4,11 +4,16 @@
 #include "libnibi/cell.hpp"
 #include "libnibi/environment.hpp"
 #include "libnibi/error.hpp"
+#include "libnibi/interpreter/eval_cache.hpp"
+#include "libnibi/interpreter/jit/jit.hpp"
 #include "libnibi/interfaces/instruction_processor_if.hpp"
 #include "libnibi/modules.hpp"
 #include "libnibi/source.hpp"
 
+#include <optional>
 #include <stack>
+#include <utility>
+#include <vector>
 
 #define PROFILE_INTERPRETER 0
 
@@ -31,14 +36,38 @@ public:
     //! \brief Construct a new exception
     //! \param message The message that will be printed
     //! \param source_location The location in the source code
-    exception_c(std::string message, locator_ptr source_location)
+    exception_c(std::string message, location_s source_location)
         : message_(message), source_location_(source_location) {}
     char *what() { return const_cast<char *>(message_.c_str()); }
-    locator_ptr get_source_location() const { return source_location_; }
+    location_s get_source_location() const { return source_location_; }
 
   private:
     std::string message_;
-    locator_ptr source_location_{nullptr};
+    location_s source_location_;
+  };
+
+  //! \brief The arguments of a call to a cell_eager_fn_t, pushed onto the
+  //!        operand stack as they are evaluated and popped from it once
+  //!        the frame is left
+  class operand_frame_c final {
+  public:
+    operand_frame_c(interpreter_c &ci)
+        : operands_(ci.operands_), base_(ci.operands_.size()) {}
+    ~operand_frame_c() { operands_.resize(base_); }
+    operand_frame_c(const operand_frame_c &) = delete;
+    operand_frame_c &operator=(const operand_frame_c &) = delete;
+
+    void push(cell_ptr cell) { operands_.push_back(std::move(cell)); }
+
+    //! \brief Get the arguments pushed in the frame
+    //! \note  Only valid until anything else is pushed onto the stack
+    cell_args_t args() const {
+      return {operands_.data() + base_, operands_.size() - base_};
+    }
+
+  private:
+    std::vector<cell_ptr> &operands_;
+    std::size_t base_;
   };
 
   //! \brief Construct a new interpreter object
@@ -56,20 +85,181 @@ public:
   cell_ptr process_cell(cell_ptr instruction, env_c &env,
                         const bool process_data_cell = false);
 
+  //! \brief Process a cell in statement position, whose value is only
+  //!        used once the caller has checked is_completing
+  //! \note  A throw made within a try is only carried through
+  //!        statements, anywhere else it is raised as an exception_c so
+  //!        nothing goes on to use the value of what threw
+  cell_ptr process_statement(cell_ptr &cell, env_c &env,
+                             const bool process_data_cell = true) {
+    // Only lists are evaluated by handle_list_cell, which takes the flag
+    statement_ = cell && cell->type == cell_type_e::LIST;
+    return process_cell(cell, env, process_data_cell);
+  }
+
+  //! \brief Execute a cell, lowering it to bytecode first if
+  //!        doing so is enabled and expected to pay off
+  //! \param cell The cell to execute
+  //! \param env The environment to execute the cell in
+  //! \return The result of the execution
+  cell_ptr execute(cell_ptr &cell, env_c &env);
+
+  //! \brief Execute a cell that is executed repeatedly
+  //! \param cell The cell to execute
+  //! \param env The environment to execute the cell in
+  //! \param lowered Where the cell is kept once it has been considered
+  //!        for lowering, so that it is only ever lowered once
+  //! \return The result of the execution
+  cell_ptr execute(cell_ptr &cell, env_c &env,
+                   std::optional<std::shared_ptr<vm::chunk_c>> &lowered);
+
+  //! \brief Execute the body of a lambda function
+  //! \param lambda The lambda whose body will be executed. The
+  //!        lowered body is cached on the lambda for later calls, and
+  //!        compiled to native code once the lambda is hot
+  //! \param env The environment populated with the lambda's arguments
+  //! \return The result of the body
+  cell_ptr execute_lambda_body(lambda_info_s &lambda, env_c &env);
+
+  //! \brief Call the function an instruction resolved to
+  //! \param cell The instruction list being executed
+  //! \param operation The function cell the head of the list resolved to
+  //! \param env The environment to execute the call in
+  //! \return The result of the call
+  cell_ptr call(cell_ptr &cell, cell_ptr &operation, env_c &env);
+
+  //! \brief Evaluate the arguments of an instruction onto the operand
+  //!        stack and call a builtin that takes them evaluated
+  //! \param fn The builtin
+  //! \param list The instruction list, headed by the builtin
+  //! \param env The environment to evaluate the arguments in
+  //! \return The result of the call
+  cell_ptr call_eager(cell_eager_fn_t fn, cell_list_t &list, env_c &env);
+
+  //! \brief A call to a lambda made in tail position of a lambda body.
+  //!        It is left for the caller of the body to make once the body
+  //!        has unwound, so that recursion runs in constant stack
+  struct tail_call_s {
+    cell_ptr operation;    // The lambda to call
+    cell_list_t arguments; // Arguments, evaluated by the body
+    bool yielded{false};   // The call was the value of a yield
+  };
+
+  //! \brief Check if a call in tail position may be made as a tail call
+  //! \param cell The instruction list of the call
+  //! \param operation The function cell the call resolved to
+  //! \param env The environment of the body making the call
+  //! \note  Calls are never made as tail calls while the body has
+  //!        deferred instructions, as they must run after the call.
+  //!        Nor are calls to or given lambdas defined within the frame
+  //!        of the body, as they would outlive it
+  bool can_tail_call(cell_ptr &cell, cell_ptr &operation, env_c &env);
+
+  //! \brief Make a call in tail position as a tail call
+  //! \param cell The instruction list of the call
+  //! \param operation The lambda the call resolved to
+  //! \param env The environment of the body making the call
+  //! \param yielded True iff the call was the value of a yield
+  //! \note  The arguments are evaluated, and the body is unwound as if
+  //!        it had yielded, see take_tail_call
+  void tail_call(cell_ptr &cell, cell_ptr &operation, env_c &env,
+                 bool yielded);
+
+  //! \brief Take the tail call made by the body that was just executed
+  //! \return The tail call, if the body made one
+  std::optional<tail_call_s> take_tail_call() {
+    return std::exchange(tail_call_, std::nullopt);
+  }
+
   void indicate_repl() { flags_.repl_mode = true; };
 
-  void set_yield_value(cell_ptr value) { stored_cells_.yield_value = value; }
+  //! \brief Yield a value from the body being executed
+  //! \param value The value the body gives
+  //! \note  Evaluation completes as a yield until the body is left,
+  //!        see end_yield
+  void yield(cell_ptr value) {
+    stored_cells_.yield_value = value;
+    if (completion_ == completion_e::NORMAL) {
+      completion_ = completion_e::YIELD;
+    }
+  }
+
+  //! \brief Indicate that the body a yield was made in has been left,
+  //!        so evaluation carries on normally
+  void end_yield() {
+    stored_cells_.yield_value = nullptr;
+    if (completion_ == completion_e::YIELD) {
+      completion_ = completion_e::NORMAL;
+    }
+  }
 
-  bool is_yielding() { return stored_cells_.yield_value != nullptr; }
+  bool is_yielding() const { return completion_ == completion_e::YIELD; }
 
   cell_ptr get_yield_value() { return stored_cells_.yield_value; }
 
+  //! \brief Check if evaluation is being cut short, by a yield or by
+  //!        the interpreter terminating
+  //! \note  Anything that evaluates a sequence should stop once this is
+  //!        set, and give the completion value
+  bool is_completing() const { return completion_ != completion_e::NORMAL; }
+
+  //! \brief Get the value of evaluation that was cut short
+  cell_ptr get_completion_value();
+
+  //! \brief Throw an error to the innermost try
+  //! \param error The error, given to the try as `$e`
+  //! \param location Where the error was thrown from
+  //! \note  Within a try evaluation completes as a throw until the try
+  //!        takes the error, see take_thrown. Outside of one the error
+  //!        is raised as an exception_c
+  void throw_error(cell_ptr error, location_s location);
+
+  bool is_throwing() const { return completion_ == completion_e::THROW; }
+
+  //! \brief Take the error being thrown, so evaluation carries on
+  cell_ptr take_thrown();
+
+  //! \brief How deep in calls and contexts the interpreter is
+  struct depth_s {
+    std::size_t calls;
+    std::size_t ctxs;
+  };
+
+  depth_s get_depth() const { return {call_stack_.size(), ctxs_.size()}; }
+
+  //! \brief Leave the calls and contexts an exception was raised
+  //!        from, back to a depth the interpreter was at before
+  //! \note  Anything deferred within the contexts is discarded
+  void unwind_to(depth_s depth);
+
+  //! \brief Add calls to the trace of an exception being raised, for
+  //!        calls that were made without being traced, see vm::execute
+  //! \param depth The depth the calls were made at, so that they are
+  //!        traced beneath any calls that were made within them
+  //! \param calls The heads of the calls, outermost first
+  void trace_calls(std::size_t depth, const cell_list_t &calls);
+
+  //! \brief Indicate that a try is being attempted
+  void enter_try() { try_depth_++; }
+
+  //! \brief Indicate that a try attempt has been left
+  void leave_try() { try_depth_--; }
+
   source_manager_c &get_source_manager() { return source_manager_; }
 
   cell_ptr get_last_result() { return stored_cells_.last_result; }
 
   env_c &get_env() { return interpreter_env; }
 
+  eval_cache_c &get_eval_cache() { return eval_cache_; }
+
+  const jit::stats_s &get_jit_stats() const { return jit_stats_; }
+
+  //! \brief Get the number of lambda bodies loaded compiled ahead of time
+  std::size_t get_aot_bodies() const {
+    return modules_.get_compiled_bodies();
+  }
+
   void defer_execution(cell_ptr ins) {
     if (ctxs_.empty()) {
       push_ctx();
@@ -85,20 +275,31 @@ public:
 
   void terminate();
 
-  bool is_terminating() const { return flags_.terminate; }
+  bool is_terminating() const {
+    return completion_ == completion_e::TERMINATE;
+  }
 
 private:
+  //! \brief How the evaluation in progress completes
+  enum class completion_e : uint8_t {
+    NORMAL,   // Evaluation carries on
+    YIELD,    // A yield is leaving the body it was made in
+    THROW,    // A throw is leaving the statements up to its try
+    TERMINATE // The interpreter has been terminated
+  };
+
   struct ctx_s {
     std::vector<cell_ptr> deferred;
   };
 
   struct flags_s {
     bool repl_mode{false};
-    bool terminate{false};
   };
 
   struct stored_cells_s {
     cell_ptr yield_value{nullptr};
+    cell_ptr thrown{nullptr};
+    location_s thrown_location;
     cell_ptr last_result{nullptr};
   };
 
@@ -108,15 +309,35 @@ private:
 
   modules_c modules_;
 
+  eval_cache_c eval_cache_;
+
+  jit::stats_s jit_stats_;
+
   std::stack<cell_ptr> call_stack_;
 
+  std::vector<cell_ptr> operands_; // See operand_frame_c
+
   std::stack<ctx_s> ctxs_;
 
+  completion_e completion_{completion_e::NORMAL};
+  bool statement_{false};
+  std::size_t try_depth_{0};
   flags_s flags_;
   stored_cells_s stored_cells_;
+  std::optional<tail_call_s> tail_call_;
 
   cell_ptr handle_list_cell(cell_ptr &cell, env_c &env, bool process_data_cell);
 
+  [[noreturn]] void raise_thrown();
+
+  cell_ptr process_body(cell_ptr &cell, env_c &env, bool tail);
+  bool try_tail_call(cell_ptr &cell, env_c &env, bool yielded);
+
+  std::shared_ptr<vm::chunk_c> lower(cell_ptr &cell);
+
+  std::optional<cell_ptr> execute_native(lambda_info_s &lambda,
+                                         vm::chunk_c &chunk, env_c &env);
+
   void halt_with_error(error_c error);
 
 #if PROFILE_INTERPRETER
@@ -0,0 +1,196 @@
+#include "assembler.hpp"
+
+namespace nibi {
+namespace jit {
+
+namespace {
+
+inline uint8_t code_of(gpr_e reg) { return static_cast<uint8_t>(reg); }
+
+inline uint8_t code_of(xmm_e reg) { return static_cast<uint8_t>(reg); }
+
+// ModRM for a register direct operand
+inline uint8_t direct(uint8_t reg, uint8_t rm) {
+  return 0xC0 | (reg << 3) | rm;
+}
+
+} // namespace
+
+void assembler_c::emit32(uint32_t value) {
+  for (auto i = 0; i < 4; i++) {
+    emit(static_cast<uint8_t>(value >> (i * 8)));
+  }
+}
+
+// [rdi + disp32]
+void assembler_c::frame_operand(uint8_t reg, std::size_t word) {
+  emit(0x80 | (reg << 3) | code_of(gpr_e::RDI));
+  emit32(static_cast<uint32_t>(word * sizeof(uint64_t)));
+}
+
+void assembler_c::load(gpr_e dst, std::size_t word) {
+  rex_w();
+  emit(0x8B);
+  frame_operand(code_of(dst), word);
+}
+
+void assembler_c::store(std::size_t word, gpr_e src) {
+  rex_w();
+  emit(0x89);
+  frame_operand(code_of(src), word);
+}
+
+void assembler_c::load(xmm_e dst, std::size_t word) {
+  emit(0xF2);
+  emit(0x0F);
+  emit(0x10);
+  frame_operand(code_of(dst), word);
+}
+
+void assembler_c::store(std::size_t word, xmm_e src) {
+  emit(0xF2);
+  emit(0x0F);
+  emit(0x11);
+  frame_operand(code_of(src), word);
+}
+
+void assembler_c::move(gpr_e dst, uint64_t value) {
+  rex_w();
+  emit(0xB8 | code_of(dst));
+  emit32(static_cast<uint32_t>(value));
+  emit32(static_cast<uint32_t>(value >> 32));
+}
+
+void assembler_c::move(gpr_e dst, gpr_e src) {
+  rex_w();
+  emit(0x89);
+  emit(direct(code_of(src), code_of(dst)));
+}
+
+void assembler_c::add(gpr_e dst, gpr_e src) {
+  rex_w();
+  emit(0x01);
+  emit(direct(code_of(src), code_of(dst)));
+}
+
+void assembler_c::sub(gpr_e dst, gpr_e src) {
+  rex_w();
+  emit(0x29);
+  emit(direct(code_of(src), code_of(dst)));
+}
+
+void assembler_c::imul(gpr_e dst, gpr_e src) {
+  rex_w();
+  emit(0x0F);
+  emit(0xAF);
+  emit(direct(code_of(dst), code_of(src)));
+}
+
+void assembler_c::cqo() {
+  rex_w();
+  emit(0x99);
+}
+
+void assembler_c::idiv(gpr_e divisor) {
+  rex_w();
+  emit(0xF7);
+  emit(direct(7, code_of(divisor)));
+}
+
+void assembler_c::test(gpr_e lhs, gpr_e rhs) {
+  rex_w();
+  emit(0x85);
+  emit(direct(code_of(rhs), code_of(lhs)));
+}
+
+void assembler_c::cmp(gpr_e lhs, gpr_e rhs) {
+  rex_w();
+  emit(0x39);
+  emit(direct(code_of(rhs), code_of(lhs)));
+}
+
+void assembler_c::cmp(gpr_e lhs, int8_t rhs) {
+  rex_w();
+  emit(0x83);
+  emit(direct(7, code_of(lhs)));
+  emit(static_cast<uint8_t>(rhs));
+}
+
+void assembler_c::set(cond_e cond, gpr_e dst) {
+  emit(0x0F);
+  emit(0x90 | static_cast<uint8_t>(cond));
+  emit(direct(0, code_of(dst)));
+}
+
+void assembler_c::zero_extend(gpr_e dst, gpr_e src) {
+  emit(0x0F);
+  emit(0xB6);
+  emit(direct(code_of(dst), code_of(src)));
+}
+
+void assembler_c::and8(gpr_e dst, gpr_e src) {
+  emit(0x20);
+  emit(direct(code_of(src), code_of(dst)));
+}
+
+void assembler_c::or8(gpr_e dst, gpr_e src) {
+  emit(0x08);
+  emit(direct(code_of(src), code_of(dst)));
+}
+
+void assembler_c::sse(sse_e op, xmm_e dst, xmm_e src) {
+  emit(0xF2);
+  emit(0x0F);
+  emit(static_cast<uint8_t>(op));
+  emit(direct(code_of(dst), code_of(src)));
+}
+
+void assembler_c::ucomisd(xmm_e lhs, xmm_e rhs) {
+  emit(0x66);
+  emit(0x0F);
+  emit(0x2E);
+  emit(direct(code_of(lhs), code_of(rhs)));
+}
+
+void assembler_c::xorpd(xmm_e dst, xmm_e src) {
+  emit(0x66);
+  emit(0x0F);
+  emit(0x57);
+  emit(direct(code_of(dst), code_of(src)));
+}
+
+void assembler_c::cvttsd2si(gpr_e dst, xmm_e src) {
+  emit(0xF2);
+  rex_w();
+  emit(0x0F);
+  emit(0x2C);
+  emit(direct(code_of(dst), code_of(src)));
+}
+
+assembler_c::fixup_t assembler_c::jump() {
+  emit(0xE9);
+  emit32(0);
+  return offset();
+}
+
+assembler_c::fixup_t assembler_c::jump(cond_e cond) {
+  emit(0x0F);
+  emit(0x80 | static_cast<uint8_t>(cond));
+  emit32(0);
+  return offset();
+}
+
+// Fixups are the offset following the displacement, which is what the
+// displacement is relative to
+void assembler_c::bind(fixup_t fixup, std::size_t target) {
+  auto displacement = static_cast<uint32_t>(
+      static_cast<int64_t>(target) - static_cast<int64_t>(fixup));
+  for (auto i = 0; i < 4; i++) {
+    code_[fixup - 4 + i] = static_cast<uint8_t>(displacement >> (i * 8));
+  }
+}
+
+void assembler_c::ret() { emit(0xC3); }
+
+} // namespace jit
+} // namespace nibi
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nibi {
+namespace jit {
+
+//! \brief General purpose registers the assembler encodes
+//! \note  Only the low eight are used, so no operand needs REX.R/B.
+//!        RDI holds the frame the code operates on
+enum class gpr_e : uint8_t { RAX = 0, RCX = 1, RDX = 2, RDI = 7 };
+
+//! \brief SSE registers the assembler encodes
+enum class xmm_e : uint8_t { XMM0 = 0, XMM1 = 1, XMM2 = 2 };
+
+//! \brief Condition codes, as encoded in the low nibble of Jcc and SETcc
+enum class cond_e : uint8_t {
+  O,
+  NO,
+  B,
+  AE,
+  E,
+  NE,
+  BE,
+  A,
+  S,
+  NS,
+  P,
+  NP,
+  L,
+  GE,
+  LE,
+  G
+};
+
+//! \brief Scalar double operations
+enum class sse_e : uint8_t { ADD = 0x58, MUL = 0x59, SUB = 0x5C, DIV = 0x5E };
+
+//! \brief Emits x86-64 machine code for values held in a frame of 64 bit
+//!        words addressed through RDI
+//! \note  Jumps are emitted with 32 bit displacements and are patched
+//!        once the offset they target is known, see bind
+class assembler_c {
+public:
+  //! \brief A jump waiting for the offset it targets
+  using fixup_t = std::size_t;
+
+  //! \brief Get the code emitted so far
+  const std::vector<uint8_t> &code() const { return code_; }
+
+  //! \brief Get the offset the next instruction is emitted at
+  std::size_t offset() const { return code_.size(); }
+
+  //! \brief mov dst, [rdi + 8 * word]
+  void load(gpr_e dst, std::size_t word);
+
+  //! \brief mov [rdi + 8 * word], src
+  void store(std::size_t word, gpr_e src);
+
+  //! \brief movsd dst, [rdi + 8 * word]
+  void load(xmm_e dst, std::size_t word);
+
+  //! \brief movsd [rdi + 8 * word], src
+  void store(std::size_t word, xmm_e src);
+
+  //! \brief mov dst, imm64
+  void move(gpr_e dst, uint64_t value);
+
+  //! \brief mov dst, src
+  void move(gpr_e dst, gpr_e src);
+
+  void add(gpr_e dst, gpr_e src);
+  void sub(gpr_e dst, gpr_e src);
+  void imul(gpr_e dst, gpr_e src);
+
+  //! \brief Sign extend RAX into RDX
+  void cqo();
+
+  //! \brief Divide RDX:RAX, leaving the quotient in RAX and the
+  //!        remainder in RDX
+  void idiv(gpr_e divisor);
+
+  void test(gpr_e lhs, gpr_e rhs);
+  void cmp(gpr_e lhs, gpr_e rhs);
+  void cmp(gpr_e lhs, int8_t rhs);
+
+  //! \brief Set the low byte of a register from a condition
+  void set(cond_e cond, gpr_e dst);
+
+  //! \brief Zero extend the low byte of a register into all of it
+  void zero_extend(gpr_e dst, gpr_e src);
+
+  //! \brief and/or of the low bytes of two registers
+  void and8(gpr_e dst, gpr_e src);
+  void or8(gpr_e dst, gpr_e src);
+
+  void sse(sse_e op, xmm_e dst, xmm_e src);
+  void ucomisd(xmm_e lhs, xmm_e rhs);
+  void xorpd(xmm_e dst, xmm_e src);
+
+  //! \brief Truncate a double into a register
+  void cvttsd2si(gpr_e dst, xmm_e src);
+
+  //! \brief Emit a jump whose target is bound later
+  fixup_t jump();
+
+  //! \brief Emit a conditional jump whose target is bound later
+  fixup_t jump(cond_e cond);
+
+  //! \brief Point a jump at an offset
+  void bind(fixup_t fixup, std::size_t target);
+
+  void ret();
+
+private:
+  std::vector<uint8_t> code_;
+
+  void emit(uint8_t byte) { code_.push_back(byte); }
+  void emit32(uint32_t value);
+  void frame_operand(uint8_t reg, std::size_t word);
+  void rex_w() { emit(0x48); }
+};
+
+} // namespace jit
+} // namespace nibi
@@ -0,0 +1,910 @@
+#include "jit.hpp"
+
+#include "libnibi/environment.hpp"
+#include "libnibi/interpreter/interpreter.hpp"
+#include "libnibi/interpreter/jit/assembler.hpp"
+
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+#if NIBI_JIT_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace nibi {
+namespace jit {
+
+#if NIBI_JIT_SUPPORTED
+
+namespace {
+
+using vm::arith_e;
+using vm::cmp_e;
+using vm::op_e;
+using vm::operand_t;
+
+// What a value is known to be at an instruction
+enum class kind_e : uint8_t { NONE, NIL, I64, F64, CONFLICT };
+
+// Origins of a register other than the variable it holds the cell of
+constexpr int32_t NO_ORIGIN = -1;
+constexpr int32_t ANY_ORIGIN = -2;
+
+// Depths of a variable other than that of the scope it is bound in
+constexpr int32_t UNBOUND = -1;
+constexpr int32_t ANY_DEPTH = -2;
+
+// A register. The machine holds the cell of a variable in the register
+// it was loaded into, so setting the variable changes the register too
+struct value_s {
+  kind_e kind{kind_e::NONE};
+  int32_t origin{NO_ORIGIN};
+  bool operator==(const value_s &) const = default;
+};
+
+// A frame slot, or a name bound by the body
+struct variable_s {
+  int32_t depth{UNBOUND};
+  kind_e kind{kind_e::NONE};
+  bool argument{false}; // Bound to the cell its argument was given as
+  bool unsure{false};   // Bound at its depth, or not bound at all
+  bool operator==(const variable_s &) const = default;
+};
+
+struct state_s {
+  bool reached{false};
+  int32_t depth{0};
+  std::vector<value_s> registers;
+  std::vector<variable_s> variables;
+};
+
+// Raised for anything the body does that isn't compiled
+struct unsupported_s {};
+
+inline kind_e join(kind_e lhs, kind_e rhs) {
+  return lhs == rhs ? lhs : kind_e::CONFLICT;
+}
+
+inline kind_e kind_of(cell_type_e type) {
+  switch (type) {
+  case cell_type_e::NIL:
+    return kind_e::NIL;
+  case cell_type_e::I64:
+    return kind_e::I64;
+  case cell_type_e::F64:
+    return kind_e::F64;
+  default:
+    return kind_e::CONFLICT;
+  }
+}
+
+inline cell_type_e type_of(kind_e kind) {
+  switch (kind) {
+  case kind_e::NIL:
+    return cell_type_e::NIL;
+  case kind_e::I64:
+    return cell_type_e::I64;
+  case kind_e::F64:
+    return cell_type_e::F64;
+  default:
+    throw unsupported_s{};
+  }
+}
+
+inline kind_e number(const value_s &value) {
+  if (value.kind != kind_e::I64 && value.kind != kind_e::F64) {
+    throw unsupported_s{};
+  }
+  return value.kind;
+}
+
+inline cond_e condition_of(cmp_e op) {
+  switch (op) {
+  case cmp_e::EQ:
+    return cond_e::E;
+  case cmp_e::NEQ:
+    return cond_e::NE;
+  case cmp_e::LT:
+    return cond_e::L;
+  case cmp_e::GT:
+    return cond_e::G;
+  case cmp_e::LTE:
+    return cond_e::LE;
+  case cmp_e::GTE:
+    return cond_e::GE;
+  default:
+    throw unsupported_s{};
+  }
+}
+
+// Translates a chunk by first working out what every register and
+// variable holds at each of its instructions, and then emitting code
+// specialized on it. Variables are the slots of the frame followed by
+// the names bound by the body, and are held in the frame after the
+// registers
+class translator_c {
+public:
+  struct program_s {
+    assembler_c assembler;
+    std::vector<function_c::exit_s> exits;
+    std::vector<std::size_t> written;
+    std::vector<cell_ptr> written_symbols;
+    std::vector<symbol_id_t> bound;
+    std::size_t frame_size{0};
+  };
+
+  translator_c(vm::chunk_c &chunk, lambda_info_s &lambda,
+               const std::vector<cell_type_e> &params)
+      : chunk_(chunk), constants_(chunk.constants),
+        num_registers_(chunk.num_registers),
+        num_slots_(lambda.slot_symbols.size()), num_params_(params.size()),
+        states_(chunk.code.size()), written_symbols_(params.size()),
+        assigned_(params.size()), labels_(chunk.code.size()) {
+    collect_names();
+
+    auto &entry = states_[0];
+    entry.reached = true;
+    entry.registers.resize(num_registers_);
+    entry.variables.resize(num_slots_ + names_.size());
+    for (std::size_t i = 0; i < num_params_; i++) {
+      entry.variables[i] = variable_s{0, kind_of(params[i]), true, false};
+    }
+    binds_.resize(entry.variables.size());
+  }
+
+  std::optional<program_s> translate() {
+    try {
+      analyze();
+      for (std::size_t i = 0; i < num_params_; i++) {
+        if (written_symbols_[i] && assigned_[i]) {
+          return std::nullopt;
+        }
+      }
+      generate();
+    } catch (const unsupported_s &) {
+      return std::nullopt;
+    }
+
+    program_.frame_size = num_registers_ + num_slots_ + names_.size();
+    for (std::size_t i = 0; i < num_params_; i++) {
+      if (written_symbols_[i]) {
+        program_.written.push_back(i);
+        program_.written_symbols.push_back(written_symbols_[i]);
+      }
+    }
+    for (std::size_t i = 0; i < binds_.size(); i++) {
+      if (binds_[i]) {
+        program_.bound.push_back(*binds_[i]);
+      }
+    }
+    return std::move(program_);
+  }
+
+private:
+  using successors_t = std::vector<std::size_t>;
+
+  vm::chunk_c &chunk_;
+  std::vector<cell_ptr> &constants_;
+  std::size_t num_registers_;
+  std::size_t num_slots_;
+  std::size_t num_params_;
+
+  std::unordered_map<symbol_id_t, std::size_t> names_;
+  std::vector<state_s> states_;
+
+  // The symbol each parameter is first set through, and the parameters
+  // that are assigned
+  std::vector<cell_ptr> written_symbols_;
+  std::vector<bool> assigned_;
+
+  // The symbol of each variable the body binds
+  std::vector<std::optional<symbol_id_t>> binds_;
+
+  program_s program_;
+  bool emitting_{false};
+  std::vector<std::size_t> labels_;
+  std::vector<std::pair<assembler_c::fixup_t, std::size_t>> jumps_;
+  std::vector<assembler_c::fixup_t> bailouts_;
+
+  assembler_c &as() { return program_.assembler; }
+
+  std::size_t register_word(std::size_t index) const { return index; }
+
+  std::size_t variable_word(std::size_t index) const {
+    return num_registers_ + index;
+  }
+
+  void collect_names() {
+    for (auto &ins : chunk_.code) {
+      if (ins.op != op_e::ASSIGN && ins.op != op_e::LOAD_SYM) {
+        continue;
+      }
+      auto id = constants_[ins.b]->as_symbol_id();
+      if (!names_.count(id)) {
+        auto index = num_slots_ + names_.size();
+        names_[id] = index;
+      }
+    }
+  }
+
+  std::size_t name_of(operand_t constant) {
+    return names_.at(constants_[constant]->as_symbol_id());
+  }
+
+  void analyze() {
+    std::vector<std::size_t> pending{0};
+    while (!pending.empty()) {
+      auto pc = pending.back();
+      pending.pop_back();
+      auto state = states_[pc];
+      for (auto next : step(pc, state)) {
+        if (merge(next, state)) {
+          pending.push_back(next);
+        }
+      }
+    }
+  }
+
+  bool merge(std::size_t pc, const state_s &incoming) {
+    if (pc >= states_.size()) {
+      throw unsupported_s{};
+    }
+    auto &state = states_[pc];
+    if (!state.reached) {
+      state = incoming;
+      state.reached = true;
+      return true;
+    }
+    if (state.depth != incoming.depth) {
+      throw unsupported_s{};
+    }
+
+    bool changed{false};
+    for (std::size_t i = 0; i < state.registers.size(); i++) {
+      auto &current = state.registers[i];
+      auto &other = incoming.registers[i];
+      value_s joined{join(current.kind, other.kind),
+                     current.origin == other.origin ? current.origin
+                                                    : ANY_ORIGIN};
+      if (joined != current) {
+        current = joined;
+        changed = true;
+      }
+    }
+    for (std::size_t i = 0; i < state.variables.size(); i++) {
+      auto &current = state.variables[i];
+      auto &other = incoming.variables[i];
+      if (current.argument != other.argument) {
+        throw unsupported_s{};
+      }
+      auto joined = current;
+      joined.kind = join(current.kind, other.kind);
+      if (current.depth == other.depth) {
+        joined.unsure = current.unsure || other.unsure;
+      } else if (current.depth == UNBOUND && other.depth >= 0) {
+        joined.depth = other.depth;
+        joined.unsure = true;
+      } else if (other.depth == UNBOUND && current.depth >= 0) {
+        joined.unsure = true;
+      } else {
+        joined.depth = ANY_DEPTH;
+      }
+      if (joined != current) {
+        current = joined;
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  void generate() {
+    emitting_ = true;
+    for (std::size_t pc = 0; pc < states_.size(); pc++) {
+      labels_[pc] = as().offset();
+      if (!states_[pc].reached) {
+        continue;
+      }
+      auto state = states_[pc];
+      step(pc, state);
+    }
+
+    auto bailout = as().offset();
+    as().move(gpr_e::RAX, static_cast<uint64_t>(-1));
+    as().ret();
+
+    for (auto &[fixup, pc] : jumps_) {
+      as().bind(fixup, labels_[pc]);
+    }
+    for (auto fixup : bailouts_) {
+      as().bind(fixup, bailout);
+    }
+  }
+
+  void copy(std::size_t to, std::size_t from) {
+    if (emitting_) {
+      as().load(gpr_e::RAX, from);
+      as().store(to, gpr_e::RAX);
+    }
+  }
+
+  void jump_to(std::size_t pc) { jumps_.emplace_back(as().jump(), pc); }
+
+  void jump_to(cond_e cond, std::size_t pc) {
+    jumps_.emplace_back(as().jump(cond), pc);
+  }
+
+  void bail_if(cond_e cond) { bailouts_.push_back(as().jump(cond)); }
+
+  void leave(function_c::exit_s exit) {
+    if (!emitting_) {
+      return;
+    }
+    as().move(gpr_e::RAX, program_.exits.size());
+    as().ret();
+    program_.exits.push_back(std::move(exit));
+  }
+
+  // Executes an instruction on what is known of the machine before it,
+  // emitting its code when the analysis is done
+  successors_t step(std::size_t pc, state_s &state) {
+    auto &ins = chunk_.code[pc];
+    auto &registers = state.registers;
+    auto &variables = state.variables;
+
+    switch (ins.op) {
+    case op_e::NOP:
+    case op_e::JUMP_IF_TERM:
+      // Nothing the body does can terminate the interpreter
+    case op_e::STEP:
+      // Steps fall back to the arithmetic that follows them
+      break;
+    case op_e::MOVE:
+      registers[ins.a] = registers[ins.b];
+      copy(register_word(ins.a), register_word(ins.b));
+      break;
+    case op_e::LOAD_CONST: {
+      auto &constant = constants_[ins.b];
+      auto kind = kind_of(constant->type);
+      if (kind == kind_e::CONFLICT) {
+        throw unsupported_s{};
+      }
+      registers[ins.a] = value_s{kind, NO_ORIGIN};
+      if (emitting_ && kind != kind_e::NIL) {
+        as().move(gpr_e::RAX, constant->data.u64);
+        as().store(register_word(ins.a), gpr_e::RAX);
+      }
+      break;
+    }
+    case op_e::LOAD_NIL:
+      registers[ins.a] = value_s{kind_e::NIL, NO_ORIGIN};
+      break;
+    case op_e::LOAD_LAST_RESULT:
+      // The value of an `if` without an else is compiled as long as
+      // nothing reads it
+      registers[ins.a] = value_s{kind_e::CONFLICT, NO_ORIGIN};
+      break;
+    case op_e::LOAD_SLOT:
+      load(state, ins.a, ins.b);
+      break;
+    case op_e::LOAD_SYM:
+      load(state, ins.a, name_of(ins.b));
+      break;
+    case op_e::ASSIGN: {
+      auto index = name_of(ins.b);
+      auto &variable = variables[index];
+      if (variable.depth == ANY_DEPTH ||
+          (variable.unsure && variable.depth != state.depth)) {
+        throw unsupported_s{};
+      }
+      if (variable.depth == UNBOUND || variable.unsure) {
+        variable.depth = state.depth;
+        variable.unsure = false;
+        binds_[index] = constants_[ins.b]->as_symbol_id();
+      }
+      assign(state, ins.a, index, ins.c);
+      break;
+    }
+    case op_e::ASSIGN_SLOT: {
+      auto &variable = variables[ins.d];
+      if (variable.depth == ANY_DEPTH) {
+        throw unsupported_s{};
+      }
+      if (variable.depth == UNBOUND || variable.unsure) {
+        // Anywhere else it would be bound in the scope it's made in
+        if (state.depth) {
+          throw unsupported_s{};
+        }
+        variable.depth = 0;
+        variable.unsure = false;
+        binds_[ins.d] = constants_[ins.b]->as_symbol_id();
+      }
+      if (ins.d < num_params_) {
+        assigned_[ins.d] = true;
+      }
+      assign(state, ins.a, ins.d, ins.c);
+      break;
+    }
+    case op_e::SET:
+      set(state, ins);
+      break;
+    case op_e::ARITH:
+      arithmetic(state, ins);
+      break;
+    case op_e::CMP:
+      comparison(state, ins);
+      break;
+    case op_e::NOT: {
+      auto kind = number(registers[ins.b]);
+      registers[ins.a] = value_s{kind_e::I64, NO_ORIGIN};
+      if (emitting_) {
+        load_integer(gpr_e::RAX, ins.b, kind);
+        as().test(gpr_e::RAX, gpr_e::RAX);
+        as().set(cond_e::E, gpr_e::RAX);
+        as().zero_extend(gpr_e::RAX, gpr_e::RAX);
+        as().store(register_word(ins.a), gpr_e::RAX);
+      }
+      break;
+    }
+    case op_e::JUMP:
+      if (emitting_) {
+        jump_to(ins.a);
+      }
+      return {ins.a};
+    case op_e::JUMP_UNLESS: {
+      // Only a relaxed check truncates a float
+      auto kind = number(registers[ins.b]);
+      if (kind == kind_e::F64 && !ins.flag) {
+        throw unsupported_s{};
+      }
+      if (emitting_) {
+        load_integer(gpr_e::RAX, ins.b, kind);
+        as().test(gpr_e::RAX, gpr_e::RAX);
+        jump_to(cond_e::LE, ins.a);
+      }
+      return {ins.a, pc + 1};
+    }
+    case op_e::ENTER_ENV:
+      state.depth++;
+      break;
+    case op_e::LEAVE_ENV:
+      for (auto i = num_slots_; i < variables.size(); i++) {
+        if (variables[i].depth == state.depth) {
+          variables[i] = variable_s{};
+          forget(state, i);
+        }
+      }
+      state.depth--;
+      break;
+    case op_e::YIELD: {
+      function_c::exit_s exit;
+      exit.yields = true;
+      exit.has_value = ins.flag;
+      if (ins.flag) {
+        exit.word = register_word(ins.b);
+        exit.type = type_of(registers[ins.b].kind);
+      }
+      exit.written = written_types(state);
+      leave(std::move(exit));
+      return {};
+    }
+    case op_e::RETURN: {
+      auto &value = registers[ins.a];
+      function_c::exit_s exit;
+      exit.word = register_word(ins.a);
+      exit.type = type_of(value.kind);
+      if (value.origin >= 0 &&
+          static_cast<std::size_t>(value.origin) < num_params_ &&
+          variables[value.origin].argument) {
+        exit.param = value.origin;
+      }
+      exit.written = written_types(state);
+      leave(std::move(exit));
+      return {};
+    }
+    default:
+      // Anything that reaches into the interpreter is left to the
+      // bytecode
+      throw unsupported_s{};
+    }
+    return {pc + 1};
+  }
+
+  void load(state_s &state, operand_t dst, std::size_t index) {
+    auto &variable = state.variables[index];
+    if (variable.depth < 0 || variable.unsure) {
+      throw unsupported_s{};
+    }
+    auto kind = number(value_s{variable.kind});
+    state.registers[dst] = value_s{kind, static_cast<int32_t>(index)};
+    copy(register_word(dst), variable_word(index));
+  }
+
+  // Registers holding the cell a variable was bound to no longer
+  // follow it once it's rebound
+  void forget(state_s &state, std::size_t index) {
+    for (auto &value : state.registers) {
+      if (value.origin == static_cast<int32_t>(index)) {
+        value.origin = NO_ORIGIN;
+      }
+    }
+  }
+
+  void assign(state_s &state, operand_t dst, std::size_t index,
+              operand_t src) {
+    auto kind = number(state.registers[src]);
+    forget(state, index);
+    auto &variable = state.variables[index];
+    variable.kind = kind;
+    variable.argument = false;
+    state.registers[dst] = value_s{kind, static_cast<int32_t>(index)};
+    if (emitting_) {
+      as().load(gpr_e::RAX, register_word(src));
+      as().store(variable_word(index), gpr_e::RAX);
+      as().store(register_word(dst), gpr_e::RAX);
+    }
+  }
+
+  void set(state_s &state, vm::instruction_s &ins) {
+    auto origin = state.registers[ins.b].origin;
+    if (origin < 0) {
+      throw unsupported_s{};
+    }
+    auto &variable = state.variables[origin];
+    if (variable.depth < 0 || variable.unsure) {
+      throw unsupported_s{};
+    }
+    auto kind = number(state.registers[ins.c]);
+
+    if (emitting_) {
+      as().load(gpr_e::RAX, register_word(ins.c));
+      as().store(variable_word(origin), gpr_e::RAX);
+    }
+
+    // The cell of an argument may be a constant, which is copied rather
+    // than set, so what else holds it can't be known
+    for (std::size_t i = 0; i < state.registers.size(); i++) {
+      auto &value = state.registers[i];
+      if (value.origin == ANY_ORIGIN ||
+          (value.origin == origin && variable.argument)) {
+        value.kind = kind_e::CONFLICT;
+      } else if (value.origin == origin) {
+        value.kind = kind;
+        if (emitting_ && i != ins.a) {
+          as().store(register_word(i), gpr_e::RAX);
+        }
+      }
+    }
+
+    if (variable.argument && !written_symbols_[origin]) {
+      written_symbols_[origin] = constants_[ins.d];
+    }
+    variable.kind = kind;
+    state.registers[ins.a] = value_s{kind, origin};
+    if (emitting_) {
+      as().store(register_word(ins.a), gpr_e::RAX);
+    }
+  }
+
+  void arithmetic(state_s &state, vm::instruction_s &ins) {
+    auto op = static_cast<arith_e>(ins.flag);
+    auto kind = number(state.registers[ins.b]);
+    for (std::size_t i = 1; i < ins.c; i++) {
+      if (number(state.registers[ins.b + i]) != kind) {
+        throw unsupported_s{};
+      }
+    }
+    if (op == arith_e::POW || (op == arith_e::MOD && kind == kind_e::F64)) {
+      throw unsupported_s{};
+    }
+    state.registers[ins.a] = value_s{kind, NO_ORIGIN};
+
+    if (!emitting_) {
+      return;
+    }
+    if (kind == kind_e::I64) {
+      integer_arithmetic(op, ins);
+    } else {
+      float_arithmetic(op, ins);
+    }
+  }
+
+  void integer_arithmetic(arith_e op, vm::instruction_s &ins) {
+    as().load(gpr_e::RAX, register_word(ins.b));
+    for (std::size_t i = 1; i < ins.c; i++) {
+      as().load(gpr_e::RCX, register_word(ins.b + i));
+      switch (op) {
+      case arith_e::ADD:
+        as().add(gpr_e::RAX, gpr_e::RCX);
+        break;
+      case arith_e::SUB:
+        as().sub(gpr_e::RAX, gpr_e::RCX);
+        break;
+      case arith_e::MUL:
+        as().imul(gpr_e::RAX, gpr_e::RCX);
+        break;
+      case arith_e::DIV:
+      case arith_e::MOD:
+        // Division by zero is reported by the bytecode, and so is
+        // what dividing the lowest integer by -1 does
+        as().test(gpr_e::RCX, gpr_e::RCX);
+        bail_if(cond_e::E);
+        as().cmp(gpr_e::RCX, static_cast<int8_t>(-1));
+        bail_if(cond_e::E);
+        as().cqo();
+        as().idiv(gpr_e::RCX);
+        if (op == arith_e::MOD) {
+          as().move(gpr_e::RAX, gpr_e::RDX);
+        }
+        break;
+      default:
+        throw unsupported_s{};
+      }
+    }
+    as().store(register_word(ins.a), gpr_e::RAX);
+  }
+
+  void float_arithmetic(arith_e op, vm::instruction_s &ins) {
+    as().load(xmm_e::XMM0, register_word(ins.b));
+    for (std::size_t i = 1; i < ins.c; i++) {
+      as().load(xmm_e::XMM1, register_word(ins.b + i));
+      switch (op) {
+      case arith_e::ADD:
+        as().sse(sse_e::ADD, xmm_e::XMM0, xmm_e::XMM1);
+        break;
+      case arith_e::SUB:
+        as().sse(sse_e::SUB, xmm_e::XMM0, xmm_e::XMM1);
+        break;
+      case arith_e::MUL:
+        as().sse(sse_e::MUL, xmm_e::XMM0, xmm_e::XMM1);
+        break;
+      case arith_e::DIV: {
+        // Division by zero is reported by the bytecode
+        as().xorpd(xmm_e::XMM2, xmm_e::XMM2);
+        as().ucomisd(xmm_e::XMM1, xmm_e::XMM2);
+        auto unordered = as().jump(cond_e::P);
+        bail_if(cond_e::E);
+        as().bind(unordered, as().offset());
+        as().sse(sse_e::DIV, xmm_e::XMM0, xmm_e::XMM1);
+        break;
+      }
+      default:
+        throw unsupported_s{};
+      }
+    }
+    as().store(register_word(ins.a), xmm_e::XMM0);
+  }
+
+  void comparison(state_s &state, vm::instruction_s &ins) {
+    auto op = static_cast<cmp_e>(ins.flag);
+    auto kind = number(state.registers[ins.b]);
+    if (number(state.registers[ins.c]) != kind) {
+      throw unsupported_s{};
+    }
+    auto logical = op == cmp_e::AND || op == cmp_e::OR;
+    if (logical && kind == kind_e::F64) {
+      throw unsupported_s{};
+    }
+    state.registers[ins.a] = value_s{kind_e::I64, NO_ORIGIN};
+
+    if (!emitting_) {
+      return;
+    }
+    if (kind == kind_e::I64) {
+      as().load(gpr_e::RAX, register_word(ins.b));
+      as().load(gpr_e::RCX, register_word(ins.c));
+      if (logical) {
+        as().test(gpr_e::RAX, gpr_e::RAX);
+        as().set(cond_e::NE, gpr_e::RAX);
+        as().test(gpr_e::RCX, gpr_e::RCX);
+        as().set(cond_e::NE, gpr_e::RCX);
+        if (op == cmp_e::AND) {
+          as().and8(gpr_e::RAX, gpr_e::RCX);
+        } else {
+          as().or8(gpr_e::RAX, gpr_e::RCX);
+        }
+      } else {
+        as().cmp(gpr_e::RAX, gpr_e::RCX);
+        as().set(condition_of(op), gpr_e::RAX);
+      }
+    } else {
+      float_comparison(op, ins);
+    }
+    as().zero_extend(gpr_e::RAX, gpr_e::RAX);
+    as().store(register_word(ins.a), gpr_e::RAX);
+  }
+
+  // Unordered comparisons (NaN) are only ever true for NEQ, so the
+  // less than comparisons swap their operands to use the above conditions
+  void float_comparison(cmp_e op, vm::instruction_s &ins) {
+    as().load(xmm_e::XMM0, register_word(ins.b));
+    as().load(xmm_e::XMM1, register_word(ins.c));
+    switch (op) {
+    case cmp_e::EQ:
+      as().ucomisd(xmm_e::XMM0, xmm_e::XMM1);
+      as().set(cond_e::E, gpr_e::RAX);
+      as().set(cond_e::NP, gpr_e::RCX);
+      as().and8(gpr_e::RAX, gpr_e::RCX);
+      break;
+    case cmp_e::NEQ:
+      as().ucomisd(xmm_e::XMM0, xmm_e::XMM1);
+      as().set(cond_e::NE, gpr_e::RAX);
+      as().set(cond_e::P, gpr_e::RCX);
+      as().or8(gpr_e::RAX, gpr_e::RCX);
+      break;
+    case cmp_e::GT:
+      as().ucomisd(xmm_e::XMM0, xmm_e::XMM1);
+      as().set(cond_e::A, gpr_e::RAX);
+      break;
+    case cmp_e::GTE:
+      as().ucomisd(xmm_e::XMM0, xmm_e::XMM1);
+      as().set(cond_e::AE, gpr_e::RAX);
+      break;
+    case cmp_e::LT:
+      as().ucomisd(xmm_e::XMM1, xmm_e::XMM0);
+      as().set(cond_e::A, gpr_e::RAX);
+      break;
+    case cmp_e::LTE:
+      as().ucomisd(xmm_e::XMM1, xmm_e::XMM0);
+      as().set(cond_e::AE, gpr_e::RAX);
+      break;
+    default:
+      throw unsupported_s{};
+    }
+  }
+
+  // Load a register as an integer, truncating a float as the machine
+  // does when it checks whether a value is true
+  void load_integer(gpr_e dst, operand_t src, kind_e kind) {
+    if (kind == kind_e::F64) {
+      as().load(xmm_e::XMM0, register_word(src));
+      as().cvttsd2si(dst, xmm_e::XMM0);
+    } else {
+      as().load(dst, register_word(src));
+    }
+  }
+
+  std::vector<cell_type_e> written_types(state_s &state) {
+    std::vector<cell_type_e> types;
+    for (std::size_t i = 0; i < num_params_; i++) {
+      if (written_symbols_[i]) {
+        types.push_back(type_of(number(value_s{state.variables[i].kind})));
+      }
+    }
+    return types;
+  }
+};
+
+} // namespace
+
+function_ptr compile(vm::chunk_c &chunk, lambda_info_s &lambda,
+                     env_c &env) {
+  std::vector<cell_type_e> params;
+  for (std::size_t i = 0; i < lambda.arg_names.size(); i++) {
+    auto &cell = env.get_slot(i);
+    if (!cell || (cell->type != cell_type_e::I64 &&
+                  cell->type != cell_type_e::F64)) {
+      return nullptr;
+    }
+    params.push_back(cell->type);
+  }
+
+  auto program = translator_c(chunk, lambda, params).translate();
+  if (!program) {
+    return nullptr;
+  }
+
+  auto &code = program->assembler.code();
+  auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto size = (code.size() + page - 1) / page * page;
+  auto memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return nullptr;
+  }
+  std::memcpy(memory, code.data(), code.size());
+  if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, size);
+    return nullptr;
+  }
+
+  auto fn = std::shared_ptr<function_c>(new function_c());
+  fn->memory_ = memory;
+  fn->memory_size_ = size;
+  fn->entry_ = reinterpret_cast<function_c::entry_f>(memory);
+  fn->slots_base_ = chunk.num_registers;
+  fn->params_ = std::move(params);
+  fn->exits_ = std::move(program->exits);
+  fn->written_ = std::move(program->written);
+  fn->written_symbols_ = std::move(program->written_symbols);
+  fn->bound_ = std::move(program->bound);
+  fn->frame_.resize(program->frame_size);
+  return fn;
+}
+
+function_c::~function_c() {
+  if (memory_) {
+    munmap(memory_, memory_size_);
+  }
+}
+
+#else
+
+function_ptr compile(vm::chunk_c &chunk, lambda_info_s &lambda,
+                     env_c &env) {
+  return nullptr;
+}
+
+function_c::~function_c() {}
+
+#endif
+
+std::optional<cell_ptr> function_c::bail() {
+  bailouts_++;
+  return std::nullopt;
+}
+
+std::optional<cell_ptr> function_c::run(interpreter_c &ci, env_c &env) {
+  for (std::size_t i = 0; i < params_.size(); i++) {
+    auto &cell = env.get_slot(i);
+    if (cell->type != params_[i]) {
+      return bail();
+    }
+    frame_[slots_base_ + i] = cell->data.u64;
+  }
+
+  // Setting a parameter mustn't be seen through another
+  for (auto written : written_) {
+    for (std::size_t i = 0; i < params_.size(); i++) {
+      if (i != written && env.get_slot(i) == env.get_slot(written)) {
+        return bail();
+      }
+    }
+  }
+
+  for (auto id : bound_) {
+    if (env.get_env(id)) {
+      return bail();
+    }
+  }
+
+  auto index = entry_(frame_.data());
+  if (index < 0) {
+    return bail();
+  }
+  auto &exit = exits_[index];
+
+  for (std::size_t i = 0; i < written_.size(); i++) {
+    auto slot = written_[i];
+    auto target = env.writable(env.get_slot(slot), written_symbols_[i]);
+    cell_c::data_u data{0};
+    data.u64 = frame_[slots_base_ + slot];
+    target->update_from(exit.written[i], data);
+  }
+
+  cell_ptr value;
+  cell_c::data_u data{0};
+  data.u64 = frame_[exit.word];
+  if (exit.param) {
+    value = env.get_slot(*exit.param);
+  } else if (!exit.has_value) {
+    value = constant_integer(0);
+  } else if (exit.yields || exit.type == cell_type_e::F64) {
+    // What is yielded is bound, so it's always a cell of its own
+    value = allocate_cell(exit.type);
+    value->data = data;
+  } else if (exit.type == cell_type_e::I64) {
+    value = constant_integer(data.i64);
+  } else {
+    value = constant_nil();
+  }
+
+  if (exit.yields) {
+    ci.yield(value);
+  }
+  return value;
+}
+
+} // namespace jit
+} // namespace nibi
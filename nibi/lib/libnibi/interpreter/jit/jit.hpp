@@ -0,0 +1,116 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+#include "libnibi/interpreter/vm/bytecode.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define NIBI_JIT_SUPPORTED 1
+#else
+#define NIBI_JIT_SUPPORTED 0
+#endif
+
+namespace nibi {
+
+class interpreter_c;
+
+namespace jit {
+
+//! \brief Calls a lambda takes before its body is compiled
+static constexpr std::size_t HOT_CALLS = 16;
+
+//! \brief Bailouts a compiled body takes before it is discarded
+static constexpr std::size_t MAX_BAILOUTS = 8;
+
+//! \brief Counters kept for the compiled bodies of an interpreter
+struct stats_s {
+  uint64_t compiled{0};    // Bodies compiled to native code
+  uint64_t deoptimized{0}; // Bodies discarded after bailing out too often
+  uint64_t bailouts{0};    // Calls handed back to the bytecode
+};
+
+//! \brief A lambda body compiled to native code
+//! \note  The code is specialized on the types the parameters had when
+//!        it was compiled, and only ever holds unboxed numbers. Nothing
+//!        it computes is seen outside of it until it exits, so any call
+//!        it can't complete bails out before it has had an effect, and
+//!        the body is executed from the start as bytecode instead
+class function_c {
+public:
+  //! \brief Where the code left the body
+  struct exit_s {
+    bool yields{false};
+    bool has_value{true}; // A yield without a value yields 0
+    std::size_t word{0};  // The word of the frame holding the value
+    cell_type_e type{cell_type_e::NIL};
+
+    // The parameter the value is the cell of, if it is one
+    std::optional<std::size_t> param;
+
+    // The types of the written parameters, see written_
+    std::vector<cell_type_e> written;
+  };
+
+  function_c(const function_c &) = delete;
+  function_c &operator=(const function_c &) = delete;
+  ~function_c();
+
+  //! \brief Run the code for a call
+  //! \param ci The interpreter the call is made by
+  //! \param env The environment of the call, with its arguments bound
+  //! \return The value of the body, or std::nullopt if the call bailed
+  //!         out and must be made by the bytecode
+  std::optional<cell_ptr> run(interpreter_c &ci, env_c &env);
+
+  //! \brief Get the number of calls that bailed out
+  std::size_t get_bailouts() const { return bailouts_; }
+
+private:
+  using entry_f = int64_t (*)(uint64_t *);
+
+  friend std::shared_ptr<function_c> compile(vm::chunk_c &chunk,
+                                             lambda_info_s &lambda,
+                                             env_c &env);
+
+  function_c() = default;
+
+  void *memory_{nullptr};
+  std::size_t memory_size_{0};
+  entry_f entry_{nullptr};
+
+  std::size_t slots_base_{0};
+  std::vector<cell_type_e> params_;
+  std::vector<exit_s> exits_;
+
+  // Parameters the body sets, which the cells of its arguments are
+  // updated with when it exits, along with the symbols they were set by
+  std::vector<std::size_t> written_;
+  std::vector<cell_ptr> written_symbols_;
+
+  // Names the body binds, which must not resolve to anything when it
+  // starts, as binding them would then have set what they resolved to
+  std::vector<symbol_id_t> bound_;
+
+  std::vector<uint64_t> frame_;
+  std::size_t bailouts_{0};
+
+  std::optional<cell_ptr> bail();
+};
+
+using function_ptr = std::shared_ptr<function_c>;
+
+//! \brief Compile the lowered body of a lambda for a call
+//! \param chunk The lowered body
+//! \param lambda The lambda the body belongs to
+//! \param env The environment of the call, with its arguments bound
+//! \return The compiled body, or nullptr if the body does something
+//!         that isn't compiled or the platform isn't supported
+extern function_ptr compile(vm::chunk_c &chunk, lambda_info_s &lambda,
+                            env_c &env);
+
+} // namespace jit
+} // namespace nibi
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "libnibi/cell.hpp"
+#include "libnibi/interpreter/builtins/kernels.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace nibi {
+namespace vm {
+
+//! \brief Operations understood by the register machine
+//! \note  Operands are register indexes unless noted otherwise.
+//!        `k` operands index into the chunk's constant pool and
+//!        `ic` operands into its inline caches.
+//!        Frame slots are those of the environment the chunk
+//!        is executed in.
+enum class op_e : uint8_t {
+  NOP,
+  MOVE,             // a <- b
+  LOAD_CONST,       // a <- k[b]
+  LOAD_NIL,         // a <- nil
+  LOAD_LAST_RESULT, // a <- interpreter's last result
+  LOAD_SYM,         // a <- env lookup of symbol k[b] through ic[c]
+  LOAD_SLOT,        // a <- frame slot b, or env lookup of k[c] if unbound
+  EVAL,             // a <- tree-walk k[b] (flag: process data lists)
+  CALL,             // a <- call instruction k[b], head resolved through ic[c]
+                    //      (flag: call_e)
+  ASSIGN,           // a <- (:= k[b] c)
+  ASSIGN_SLOT,      // a <- (:= k[b] c), stored in frame slot d if bound
+  SET,              // a <- (set b c), b resolved from expression k[d]
+  STEP,             // if b is an unshared I64: b (flag) k[c] in place,
+                    //      d <- b and pc <- a
+  ARITH,            // a <- fold(flag) over c registers from b, origin k[d]
+  CMP,              // a <- b (flag) c, origin k[d]
+  NOT,              // a <- !b
+  JUMP,             // pc <- a
+  JUMP_UNLESS,      // if b not truthy: pc <- a (flag: relaxed truth check)
+  JUMP_IF_TERM,     // if interpreter terminating: pc <- a
+  ENTER_ENV,        // push a child environment of the current one
+  LEAVE_ENV,        // pop the current environment
+  PUSH_CTX,         // push an interpreter context
+  POP_CTX,          // pop an interpreter context with the current env
+  YIELD,            // yield b (flag: b holds the value, otherwise 0)
+  RETURN            // return a
+};
+
+//! \brief Arithmetic folds encoded in the flag of an ARITH instruction
+using arith_e = kernels::arith_e;
+
+//! \brief Comparisons encoded in the flag of a CMP instruction
+using cmp_e = kernels::cmp_e;
+
+//! \brief Calls encoded in the flag of a CALL instruction
+//! \note  Tail calls are left to the caller of the lambda body that
+//!        makes them, see interpreter_c::tail_call
+enum class call_e : uint8_t {
+  NORMAL,
+  TAIL,      // The value of the call is the value of the lambda body
+  TAIL_YIELD // The value of the call is yielded from the lambda body
+};
+
+using operand_t = uint16_t;
+static constexpr std::size_t MAX_OPERAND =
+    std::numeric_limits<operand_t>::max();
+
+//! \brief A single instruction
+struct instruction_s {
+  op_e op{op_e::NOP};
+  uint8_t flag{0};
+  operand_t a{0};
+  operand_t b{0};
+  operand_t c{0};
+  operand_t d{0};
+};
+
+//! \brief A unit of lowered code along with everything
+//!        required to execute it
+class chunk_c {
+public:
+  //! \brief The code lowered from a call the interpreter would make to
+  //!        a builtin, which the machine makes without it being traced
+  struct span_s {
+    std::size_t start;
+    std::size_t end;  // One past the last instruction of the call
+    operand_t origin; // The constant holding the instruction called
+  };
+
+  std::vector<instruction_s> code;
+  std::vector<cell_ptr> constants;
+  std::vector<binding_cache_s> caches;
+  std::size_t num_registers{1};
+  std::size_t max_env_depth{0};
+  std::vector<span_s> spans; // Outermost first
+};
+
+using chunk_ptr = std::shared_ptr<chunk_c>;
+
+} // namespace vm
+} // namespace nibi
@@ -0,0 +1,538 @@
+#include "compiler.hpp"
+
+#include "libnibi/interpreter/builtins/builtins.hpp"
+#include "libnibi/keywords.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace nibi {
+namespace vm {
+
+namespace {
+
+enum class form_e { ASSIGN, SET, ARITH, CMP, NOT, IF, LOOP, YIELD };
+
+struct form_s {
+  form_e form;
+  uint8_t flag{0};
+};
+
+// Builtins that the machine executes without calling back
+// into the tree-walking interpreter
+static std::unordered_map<std::string, form_s> native_forms = {
+    {nibi::kw::ASSIGN, {form_e::ASSIGN}},
+    {nibi::kw::SET, {form_e::SET}},
+    {nibi::kw::ADD, {form_e::ARITH, static_cast<uint8_t>(arith_e::ADD)}},
+    {nibi::kw::SUB, {form_e::ARITH, static_cast<uint8_t>(arith_e::SUB)}},
+    {nibi::kw::MUL, {form_e::ARITH, static_cast<uint8_t>(arith_e::MUL)}},
+    {nibi::kw::DIV, {form_e::ARITH, static_cast<uint8_t>(arith_e::DIV)}},
+    {nibi::kw::MOD, {form_e::ARITH, static_cast<uint8_t>(arith_e::MOD)}},
+    {nibi::kw::POW, {form_e::ARITH, static_cast<uint8_t>(arith_e::POW)}},
+    {nibi::kw::EQ, {form_e::CMP, static_cast<uint8_t>(cmp_e::EQ)}},
+    {nibi::kw::NEQ, {form_e::CMP, static_cast<uint8_t>(cmp_e::NEQ)}},
+    {nibi::kw::LT, {form_e::CMP, static_cast<uint8_t>(cmp_e::LT)}},
+    {nibi::kw::GT, {form_e::CMP, static_cast<uint8_t>(cmp_e::GT)}},
+    {nibi::kw::LTE, {form_e::CMP, static_cast<uint8_t>(cmp_e::LTE)}},
+    {nibi::kw::GTE, {form_e::CMP, static_cast<uint8_t>(cmp_e::GTE)}},
+    {nibi::kw::AND, {form_e::CMP, static_cast<uint8_t>(cmp_e::AND)}},
+    {nibi::kw::OR, {form_e::CMP, static_cast<uint8_t>(cmp_e::OR)}},
+    {nibi::kw::NOT, {form_e::NOT}},
+    {nibi::kw::IF, {form_e::IF}},
+    {nibi::kw::LOOP, {form_e::LOOP}},
+    {nibi::kw::YIELD, {form_e::YIELD}}};
+
+// Raised when a chunk would exceed what an operand can address
+class limit_exceeded_c final : public std::exception {};
+
+inline const form_s *lookup_form(cell_ptr &cell) {
+  if (cell->type != cell_type_e::LIST) {
+    return nullptr;
+  }
+  auto &list_info = cell->as_list_info();
+  if (list_info.type != list_types_e::INSTRUCTION || list_info.list.empty()) {
+    return nullptr;
+  }
+  auto &head = list_info.list.front();
+  if (head->type != cell_type_e::FUNCTION) {
+    return nullptr;
+  }
+  auto &fn_info = head->as_function_info();
+  if (fn_info.type != function_type_e::BUILTIN_CPP_FUNCTION) {
+    return nullptr;
+  }
+  auto it = native_forms.find(fn_info.name);
+  if (it == native_forms.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+inline bool is_valid_var_name(cell_ptr &cell) {
+  if (cell->type != cell_type_e::SYMBOL) {
+    return false;
+  }
+  auto &name = cell->as_symbol_ref();
+  return !name.empty() && name[0] != '$' && name[0] != ':';
+}
+
+// Get the operation and constant of an update that steps the symbol
+// being set by an integer, as in (set i (+ i 1))
+inline std::optional<std::pair<arith_e, cell_ptr>>
+constant_step(cell_ptr &symbol, cell_ptr &update) {
+  auto form = lookup_form(update);
+  if (!form || form->form != form_e::ARITH ||
+      symbol->type != cell_type_e::SYMBOL) {
+    return std::nullopt;
+  }
+  auto op = static_cast<arith_e>(form->flag);
+  auto &list = update->as_list();
+  if ((op != arith_e::ADD && op != arith_e::SUB) || list.size() != 3 ||
+      list[1]->type != cell_type_e::SYMBOL ||
+      list[1]->as_symbol_id() != symbol->as_symbol_id() ||
+      list[2]->type != cell_type_e::I64) {
+    return std::nullopt;
+  }
+  return std::make_pair(op, list[2]);
+}
+
+} // namespace
+
+chunk_ptr compiler_c::compile(cell_ptr &cell, bool process_data,
+                              const std::vector<symbol_id_t> *frame,
+                              bool lambda_body) {
+  if (!cell) {
+    return nullptr;
+  }
+
+  compiler_c compiler;
+  compiler.frame_ = frame;
+  try {
+    auto result = compiler.acquire_register();
+    compiler.expression(cell, result, process_data,
+                        lambda_body ? position_e::TAIL : position_e::INNER);
+    compiler.emit(op_e::RETURN, result);
+  } catch (limit_exceeded_c &) {
+    return nullptr;
+  }
+  return std::make_shared<chunk_c>(std::move(compiler.chunk_));
+}
+
+chunk_ptr compiler_c::lower_lambda(lambda_info_s &lambda) {
+  if (!lambda.chunk_attempted) {
+    lambda.chunk_attempted = true;
+    lambda.chunk = compile(lambda.body, true, &lambda.slot_symbols, true);
+  }
+  return lambda.chunk;
+}
+
+bool compiler_c::is_worth_lowering(cell_ptr &cell) {
+  if (!cell || cell->type != cell_type_e::LIST) {
+    return false;
+  }
+
+  auto &list_info = cell->as_list_info();
+  auto form = lookup_form(cell);
+
+  // Only walk what would actually be lowered, anything
+  // else is handed straight back to the interpreter
+  if (!form && list_info.type != list_types_e::DATA) {
+    return false;
+  }
+
+  if (form && form->form == form_e::LOOP) {
+    return true;
+  }
+
+  for (auto &item : list_info.list) {
+    if (is_worth_lowering(item)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+operand_t compiler_c::acquire_register() {
+  if (next_register_ >= MAX_OPERAND) {
+    throw limit_exceeded_c();
+  }
+  auto reg = next_register_++;
+  if (next_register_ > chunk_.num_registers) {
+    chunk_.num_registers = next_register_;
+  }
+  return static_cast<operand_t>(reg);
+}
+
+operand_t compiler_c::add_constant(cell_ptr &cell) {
+  if (chunk_.constants.size() >= MAX_OPERAND) {
+    throw limit_exceeded_c();
+  }
+  chunk_.constants.push_back(cell);
+  return static_cast<operand_t>(chunk_.constants.size() - 1);
+}
+
+operand_t compiler_c::add_cache() {
+  if (chunk_.caches.size() >= MAX_OPERAND) {
+    throw limit_exceeded_c();
+  }
+  chunk_.caches.emplace_back();
+  return static_cast<operand_t>(chunk_.caches.size() - 1);
+}
+
+operand_t compiler_c::current_position() {
+  if (chunk_.code.size() >= MAX_OPERAND) {
+    throw limit_exceeded_c();
+  }
+  return static_cast<operand_t>(chunk_.code.size());
+}
+
+std::size_t compiler_c::emit(op_e op, std::size_t a, std::size_t b,
+                             std::size_t c, std::size_t d, uint8_t flag) {
+  auto position = current_position();
+  chunk_.code.push_back(instruction_s{
+      op, flag, static_cast<operand_t>(a), static_cast<operand_t>(b),
+      static_cast<operand_t>(c), static_cast<operand_t>(d)});
+  return position;
+}
+
+void compiler_c::patch_jump(std::size_t at) {
+  chunk_.code[at].a = current_position();
+}
+
+std::optional<operand_t> compiler_c::frame_slot(cell_ptr &symbol) {
+  if (!frame_) {
+    return std::nullopt;
+  }
+
+  // Mirrors env_c::find_slot
+  auto id = symbol->as_symbol_id();
+  for (std::size_t i = frame_->size(); i > 0; i--) {
+    if ((*frame_)[i - 1] == id) {
+      return static_cast<operand_t>(i - 1);
+    }
+  }
+  return std::nullopt;
+}
+
+void compiler_c::enter_env() {
+  emit(op_e::ENTER_ENV);
+  env_depth_++;
+  if (env_depth_ > chunk_.max_env_depth) {
+    chunk_.max_env_depth = env_depth_;
+  }
+}
+
+void compiler_c::leave_env() {
+  emit(op_e::LEAVE_ENV);
+  env_depth_--;
+}
+
+void compiler_c::expression(cell_ptr &cell, operand_t dst, bool process_data,
+                            position_e position) {
+  switch (cell->type) {
+  case cell_type_e::LIST: {
+    auto &list_info = cell->as_list_info();
+    if (list_info.list.empty()) {
+      break;
+    }
+    switch (list_info.type) {
+    case list_types_e::DATA:
+      if (process_data) {
+        return sequence(list_info.list, dst, position);
+      }
+      break;
+    case list_types_e::ACCESS:
+      return eval(cell, dst, process_data);
+    case list_types_e::INSTRUCTION:
+      if (!native_form(cell, dst, position)) {
+        call(cell, dst, position);
+      }
+      return;
+    }
+    break;
+  }
+  case cell_type_e::SYMBOL: {
+    if (auto slot = frame_slot(cell)) {
+      emit(op_e::LOAD_SLOT, dst, *slot, add_constant(cell));
+    } else {
+      emit(op_e::LOAD_SYM, dst, add_constant(cell), add_cache());
+    }
+    return;
+  }
+  case cell_type_e::ALIAS:
+    return eval(cell, dst, process_data);
+  default:
+    break;
+  }
+
+  // Anything else evaluates to itself
+  emit(op_e::LOAD_CONST, dst, add_constant(cell));
+}
+
+void compiler_c::sequence(cell_list_t &list, operand_t dst,
+                          position_e position) {
+  // Only the last item can be in tail position, though
+  // a yield from any of them leaves the body
+  auto inner = position == position_e::INNER ? position : position_e::EXIT;
+  emit(op_e::LOAD_NIL, dst);
+  for (std::size_t i = 0; i < list.size(); i++) {
+    expression(list[i], dst, false, i == list.size() - 1 ? position : inner);
+  }
+}
+
+void compiler_c::eval(cell_ptr &cell, operand_t dst, bool process_data) {
+  emit(op_e::EVAL, dst, add_constant(cell), 0, 0, process_data);
+}
+
+void compiler_c::call(cell_ptr &cell, operand_t dst, position_e position) {
+  if (cell->as_list().front()->type != cell_type_e::SYMBOL) {
+    return eval(cell, dst, false);
+  }
+  auto kind = call_e::NORMAL;
+  if (position == position_e::TAIL) {
+    kind = call_e::TAIL;
+  } else if (position == position_e::YIELD) {
+    kind = call_e::TAIL_YIELD;
+  }
+  emit(op_e::CALL, dst, add_constant(cell), add_cache(), 0,
+       static_cast<uint8_t>(kind));
+}
+
+bool compiler_c::native_form(cell_ptr &cell, operand_t dst,
+                             position_e position) {
+  auto form = lookup_form(cell);
+  if (!form) {
+    return false;
+  }
+
+  // The interpreter traces the call to the builtin, other than for an
+  // `if` that a lambda body is left through, see process_body
+  std::optional<std::size_t> span;
+  if (form->form != form_e::IF || position == position_e::INNER) {
+    span = chunk_.spans.size();
+    chunk_.spans.push_back({current_position(), 0, 0});
+  }
+
+  // Temporaries are only live for the duration of the form
+  auto mark = next_register_;
+  bool lowered{false};
+  switch (form->form) {
+  case form_e::ASSIGN:
+    lowered = assignment(cell, dst);
+    break;
+  case form_e::SET:
+    lowered = set(cell, dst);
+    break;
+  case form_e::ARITH:
+    lowered = arithmetic(cell, dst, form->flag);
+    break;
+  case form_e::CMP:
+    lowered = comparison(cell, dst, form->flag);
+    break;
+  case form_e::NOT:
+    lowered = negation(cell, dst);
+    break;
+  case form_e::IF:
+    lowered = conditional(cell, dst, position);
+    break;
+  case form_e::LOOP:
+    lowered = loop(cell, dst);
+    break;
+  case form_e::YIELD:
+    lowered = yield(cell, dst, position);
+    break;
+  }
+  next_register_ = mark;
+
+  if (span && lowered) {
+    chunk_.spans[*span].end = current_position();
+    chunk_.spans[*span].origin = add_constant(cell);
+  } else if (span) {
+    chunk_.spans.erase(chunk_.spans.begin() + *span);
+  }
+  return lowered;
+}
+
+// Forms that don't match what the builtin expects are left to the
+// builtin so that it can report the error as it normally would
+
+bool compiler_c::assignment(cell_ptr &cell, operand_t dst) {
+  auto &list = cell->as_list();
+  if (list.size() != 3 || !is_valid_var_name(list[1])) {
+    return false;
+  }
+  expression(list[2], dst, false);
+  if (auto slot = frame_slot(list[1])) {
+    emit(op_e::ASSIGN_SLOT, dst, add_constant(list[1]), dst, *slot);
+  } else {
+    emit(op_e::ASSIGN, dst, add_constant(list[1]), dst);
+  }
+  return true;
+}
+
+bool compiler_c::set(cell_ptr &cell, operand_t dst) {
+  auto &list = cell->as_list();
+  if (list.size() != 3) {
+    return false;
+  }
+  auto target = acquire_register();
+  expression(list[1], target, false);
+
+  // Counters are stepped without evaluating the update
+  // for as long as they hold an integer of their own
+  std::optional<std::size_t> to_end;
+  if (auto step = constant_step(list[1], list[2])) {
+    to_end = emit(op_e::STEP, 0, target, add_constant(step->second), dst,
+                  static_cast<uint8_t>(step->first));
+  }
+
+  expression(list[2], dst, false);
+  emit(op_e::SET, dst, target, dst, add_constant(list[1]));
+  if (to_end) {
+    patch_jump(*to_end);
+  }
+  return true;
+}
+
+bool compiler_c::arithmetic(cell_ptr &cell, operand_t dst, uint8_t op) {
+  auto &list = cell->as_list();
+  if (list.size() < 3) {
+    return false;
+  }
+  auto count = list.size() - 1;
+  auto base = acquire_register();
+  for (std::size_t i = 1; i < count; i++) {
+    acquire_register();
+  }
+  for (std::size_t i = 0; i < count; i++) {
+    expression(list[i + 1], base + i, false);
+  }
+  emit(op_e::ARITH, dst, base, count, add_constant(cell), op);
+  return true;
+}
+
+bool compiler_c::comparison(cell_ptr &cell, operand_t dst, uint8_t op) {
+  auto &list = cell->as_list();
+  if (list.size() != 3) {
+    return false;
+  }
+  auto lhs = acquire_register();
+  auto rhs = acquire_register();
+  expression(list[1], lhs, false);
+  expression(list[2], rhs, false);
+  emit(op_e::CMP, dst, lhs, rhs, add_constant(cell), op);
+  return true;
+}
+
+bool compiler_c::negation(cell_ptr &cell, operand_t dst) {
+  auto &list = cell->as_list();
+  if (list.size() != 2) {
+    return false;
+  }
+  expression(list[1], dst, true);
+  emit(op_e::NOT, dst, dst);
+  return true;
+}
+
+bool compiler_c::conditional(cell_ptr &cell, operand_t dst,
+                             position_e position) {
+  // (if (cond) (true) [(false)])
+  auto &list = cell->as_list();
+  if (list.size() != 3 && list.size() != 4) {
+    return false;
+  }
+
+  auto condition = acquire_register();
+  auto scope = builtins::form_scope(list);
+
+  if (scope & cell_c::SCOPE_ENV) {
+    enter_env();
+  }
+  if (scope & cell_c::SCOPE_CTX) {
+    emit(op_e::PUSH_CTX);
+  }
+  expression(list[1], condition, false);
+  if (scope & cell_c::SCOPE_CTX) {
+    emit(op_e::POP_CTX);
+  }
+
+  auto to_false = emit(op_e::JUMP_UNLESS, 0, condition);
+  expression(list[2], dst, true, position);
+  auto to_end = emit(op_e::JUMP);
+
+  patch_jump(to_false);
+  if (list.size() == 4) {
+    expression(list[3], dst, true, position);
+  } else {
+    emit(op_e::LOAD_LAST_RESULT, dst);
+  }
+
+  patch_jump(to_end);
+  if (scope & cell_c::SCOPE_ENV) {
+    leave_env();
+  }
+  return true;
+}
+
+bool compiler_c::loop(cell_ptr &cell, operand_t dst) {
+  // (loop (pre) (cond) (post) (body))
+  auto &list = cell->as_list();
+  if (list.size() != 5) {
+    return false;
+  }
+
+  auto scratch = acquire_register();
+  auto result = acquire_register();
+  auto scope = builtins::form_scope(list);
+
+  if (scope & cell_c::SCOPE_CTX) {
+    emit(op_e::PUSH_CTX);
+  }
+  if (scope & cell_c::SCOPE_ENV) {
+    enter_env();
+  }
+
+  expression(list[1], scratch, false);
+  emit(op_e::LOAD_NIL, result);
+
+  auto top = current_position();
+  auto to_end_terminated = emit(op_e::JUMP_IF_TERM);
+
+  expression(list[2], scratch, false);
+  auto to_end = emit(op_e::JUMP_UNLESS, 0, scratch, 0, 0, 1);
+
+  expression(list[4], result, true);
+  expression(list[3], scratch, false);
+  emit(op_e::JUMP, top);
+
+  patch_jump(to_end_terminated);
+  patch_jump(to_end);
+
+  if (scope & cell_c::SCOPE_CTX) {
+    emit(op_e::POP_CTX);
+  }
+  if (scope & cell_c::SCOPE_ENV) {
+    leave_env();
+  }
+  emit(op_e::MOVE, dst, result);
+  return true;
+}
+
+bool compiler_c::yield(cell_ptr &cell, operand_t dst, position_e position) {
+  auto &list = cell->as_list();
+  if (list.size() == 1) {
+    emit(op_e::YIELD, dst, dst);
+    return true;
+  }
+  if (list.size() != 2) {
+    return false;
+  }
+  expression(list[1], dst, false,
+             position == position_e::INNER ? position : position_e::YIELD);
+  emit(op_e::YIELD, dst, dst, 0, 0, 1);
+  return true;
+}
+
+} // namespace vm
+} // namespace nibi
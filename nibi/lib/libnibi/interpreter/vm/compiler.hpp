@@ -0,0 +1,86 @@
+#pragma once
+
+#include "bytecode.hpp"
+
+#include <optional>
+#include <string>
+
+namespace nibi {
+namespace vm {
+
+//! \brief Lowers parsed instruction lists into bytecode chunks.
+//!        Forms the machine understands natively (arithmetic,
+//!        comparison, assignment, `if`, `loop`, `<-`) are lowered
+//!        directly, everything else is lowered to an EVAL that
+//!        hands the cell back to the tree-walking interpreter
+class compiler_c {
+public:
+  //! \brief Lower a cell into a chunk
+  //! \param cell The cell to lower
+  //! \param process_data If true, a data list will be lowered as a
+  //!        body to execute rather than as a value
+  //! \param frame The slot names of the environment that the chunk will
+  //!        be executed in, if any. See env_c
+  //! \param lambda_body If true, the cell is the body of a lambda and
+  //!        calls in its tail position are lowered as tail calls
+  //! \return A chunk, or nullptr if the cell can not be lowered
+  static chunk_ptr compile(cell_ptr &cell, bool process_data,
+                           const std::vector<symbol_id_t> *frame = nullptr,
+                           bool lambda_body = false);
+
+  //! \brief Lower the body of a lambda, once
+  //! \param lambda The lambda, which holds onto the chunk
+  //! \return The chunk of the body, or nullptr if it can not be lowered
+  static chunk_ptr lower_lambda(lambda_info_s &lambda);
+
+  //! \brief Check if lowering a top level instruction would pay off
+  //! \param cell The instruction to check
+  //! \return True iff the instruction contains a natively lowered loop
+  static bool is_worth_lowering(cell_ptr &cell);
+
+private:
+  //! \brief Where an expression sits within a lambda body
+  enum class position_e {
+    INNER, // Neither of the below, or not in a lambda body
+    EXIT,  // A yield from here leaves the body
+    TAIL,  // The value is the value of the body
+    YIELD  // The value is yielded from the body
+  };
+
+  compiler_c() = default;
+
+  chunk_c chunk_;
+  const std::vector<symbol_id_t> *frame_{nullptr};
+  std::size_t next_register_{0};
+  std::size_t env_depth_{0};
+
+  operand_t acquire_register();
+  operand_t add_constant(cell_ptr &cell);
+  operand_t add_cache();
+  operand_t current_position();
+  std::size_t emit(op_e op, std::size_t a = 0, std::size_t b = 0,
+                   std::size_t c = 0, std::size_t d = 0, uint8_t flag = 0);
+  void patch_jump(std::size_t at);
+  std::optional<operand_t> frame_slot(cell_ptr &symbol);
+  void enter_env();
+  void leave_env();
+
+  void expression(cell_ptr &cell, operand_t dst, bool process_data,
+                  position_e position = position_e::INNER);
+  void sequence(cell_list_t &list, operand_t dst, position_e position);
+  void eval(cell_ptr &cell, operand_t dst, bool process_data);
+  void call(cell_ptr &cell, operand_t dst, position_e position);
+  bool native_form(cell_ptr &cell, operand_t dst, position_e position);
+
+  bool assignment(cell_ptr &cell, operand_t dst);
+  bool set(cell_ptr &cell, operand_t dst);
+  bool arithmetic(cell_ptr &cell, operand_t dst, uint8_t op);
+  bool comparison(cell_ptr &cell, operand_t dst, uint8_t op);
+  bool negation(cell_ptr &cell, operand_t dst);
+  bool conditional(cell_ptr &cell, operand_t dst, position_e position);
+  bool loop(cell_ptr &cell, operand_t dst);
+  bool yield(cell_ptr &cell, operand_t dst, position_e position);
+};
+
+} // namespace vm
+} // namespace nibi
@@ -0,0 +1,435 @@
+#pragma once
+
+#include "bytecode.hpp"
+
+#include "libnibi/environment.hpp"
+#include "libnibi/interpreter/interpreter.hpp"
+
+#include <optional>
+#include <vector>
+
+namespace nibi {
+namespace vm {
+
+namespace detail {
+
+inline bool is_float_type(cell_type_e type) {
+  return static_cast<uint8_t>(type) >= CELL_TYPE_MIN_FLOAT &&
+         static_cast<uint8_t>(type) <= CELL_TYPE_MAX_FLOAT;
+}
+
+// A register. Numbers the machine computes are held unboxed, and are
+// only allocated into a cell once they escape the machine; when they
+// are bound, handed to the interpreter, or returned
+struct value_s {
+  cell_ptr cell;              // The boxed value, nullptr while unboxed
+  cell_type_e type{cell_type_e::NIL};
+  cell_c::data_u data{0};
+
+  value_s() = default;
+  value_s(cell_ptr cell) : cell(std::move(cell)) {}
+
+  static value_s integer(int64_t value) {
+    value_s v;
+    v.type = cell_type_e::I64;
+    v.data.i64 = value;
+    return v;
+  }
+
+  static value_s number(cell_type_e type, cell_c::data_u data) {
+    value_s v;
+    v.type = type;
+    v.data = data;
+    return v;
+  }
+
+  cell_type_e kind() const { return cell ? cell->type : type; }
+
+  int64_t to_integer() {
+    if (cell) {
+      return cell->to_integer();
+    }
+    return is_float_type(type) ? (int64_t)cell_c::double_of(type, data)
+                               : cell_c::integer_of(type, data);
+  }
+
+  // The data of the value, boxed or not
+  const cell_c::data_u &raw() const { return cell ? cell->data : data; }
+
+  // Box the value, which may give a shared constant, see unshared
+  cell_ptr &box() {
+    if (!cell) {
+      if (type == cell_type_e::I64) {
+        cell = constant_integer(data.i64);
+      } else {
+        cell = unshared();
+      }
+    }
+    return cell;
+  }
+
+  // Allocate a cell of its own for the value
+  cell_ptr unshared() {
+    auto c = allocate_cell(type);
+    c->data = data;
+    return c;
+  }
+};
+
+// Values handed to a builtin are processed again by the builtin,
+// so anything that would not evaluate to itself is wrapped
+inline cell_ptr as_argument(value_s &operand) {
+  auto &value = operand.box();
+  switch (value->type) {
+  case cell_type_e::SYMBOL:
+  case cell_type_e::ALIAS:
+    break;
+  case cell_type_e::LIST:
+    if (value->read_list_info().type == list_types_e::DATA) {
+      return value;
+    }
+    break;
+  default:
+    return value;
+  }
+  auto wrapped = allocate_cell(alias_s{value});
+  wrapped->set_location(value->get_location());
+  return wrapped;
+}
+
+// Hand an operation the machine can't specialize to the builtin
+// that the instruction was lowered from
+inline value_s call_builtin(interpreter_c &ci, cell_ptr &origin,
+                            value_s *operands, std::size_t count,
+                            env_c &env) {
+  auto &head = origin->as_list().front();
+  auto &fn_info = head->as_function_info();
+  if (fn_info.eager) {
+    // The operands are already evaluated, so they are lent to the builtin
+    // as they are rather than being wrapped to be evaluated again
+    interpreter_c::operand_frame_c frame(ci);
+    for (std::size_t i = 0; i < count; i++) {
+      frame.push(operands[i].box());
+    }
+    return fn_info.eager(ci, frame.args(), env);
+  }
+
+  cell_list_t list;
+  list.reserve(count + 1);
+  list.push_back(head);
+  for (std::size_t i = 0; i < count; i++) {
+    list.push_back(as_argument(operands[i]));
+  }
+  return fn_info.fn(ci, list, env);
+}
+
+inline bool all_numeric(value_s *operands, std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    if (!kernels::is_numeric(operands[i].kind())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline value_s arithmetic(interpreter_c &ci, arith_e op, cell_ptr &origin,
+                          value_s *operands, std::size_t count, env_c &env) {
+  if (!all_numeric(operands, count)) {
+    return call_builtin(ci, origin, operands, count, env);
+  }
+
+  auto type = operands[0].kind();
+  auto result = operands[0].raw();
+  for (std::size_t i = 1; i < count; i++) {
+    auto &operand = operands[i];
+    if (kernels::arithmetic(op, type, result, operand.kind(), operand.raw()) !=
+        kernels::result_e::OK) {
+      throw interpreter_c::exception_c("Division by zero",
+                                       operand.box()->get_location());
+    }
+  }
+  return value_s::number(type, result);
+}
+
+inline value_s comparison(interpreter_c &ci, cmp_e op, cell_ptr &origin,
+                          value_s *operands, env_c &env) {
+  auto &lhs = operands[0];
+  auto &rhs = operands[1];
+
+  if (!all_numeric(operands, 2)) {
+    auto is_string = [](value_s &value) {
+      return value.kind() == cell_type_e::STRING;
+    };
+    if ((op == cmp_e::EQ || op == cmp_e::NEQ) && is_string(lhs) &&
+        is_string(rhs)) {
+      bool equal = kernels::strings_equal(*lhs.cell, *rhs.cell);
+      return value_s::integer(op == cmp_e::EQ ? equal : !equal);
+    }
+    return call_builtin(ci, origin, operands, 2, env);
+  }
+
+  return value_s::integer(kernels::compare(op, lhs.kind(), lhs.raw(),
+                                           rhs.kind(), rhs.raw()));
+}
+
+} // namespace detail
+
+//! \brief The state of a chunk being executed, along with the effect of
+//!        each of its instructions
+//! \note  Control flow is left to the code driving the machine. Both
+//!        vm::execute and chunks compiled ahead of time (see aot.hpp)
+//!        are written in terms of it, so that they can't disagree on
+//!        what an instruction does. Operations that may leave the chunk
+//!        return true when they do, after which the value of the chunk
+//!        is given by completion()
+class machine_c {
+public:
+  machine_c(interpreter_c &ci, chunk_c &chunk, env_c &env)
+      : ci_(ci), chunk_(chunk), env_(env), registers_(chunk.num_registers),
+        scopes_(chunk.max_env_depth), current_env_(&env),
+        call_depth_(ci.get_depth().calls) {}
+
+  //! \brief Trace an exception raised by an instruction to the calls of
+  //!        builtins it was lowered from, as the interpreter would have
+  //!        traced them had it made the calls
+  //! \param pc The index of the instruction
+  void trace(std::size_t pc) {
+    cell_list_t calls;
+    for (auto &span : chunk_.spans) {
+      if (span.start <= pc && pc < span.end) {
+        calls.push_back(chunk_.constants[span.origin]->read_list().front());
+      }
+    }
+    ci_.trace_calls(call_depth_, calls);
+  }
+
+  void move(const instruction_s &ins) {
+    registers_[ins.a] = registers_[ins.b];
+  }
+
+  void load_const(const instruction_s &ins) {
+    registers_[ins.a] = chunk_.constants[ins.b];
+  }
+
+  void load_nil(const instruction_s &ins) {
+    registers_[ins.a] = constant_nil();
+  }
+
+  void load_last_result(const instruction_s &ins) {
+    registers_[ins.a] = ci_.get_last_result();
+  }
+
+  void load_sym(const instruction_s &ins) {
+    auto &symbol = chunk_.constants[ins.b];
+    auto loaded =
+        current_env_->get(symbol->as_symbol_id(), chunk_.caches[ins.c]);
+    if (!loaded) {
+      not_found(symbol);
+    }
+    registers_[ins.a] = loaded;
+  }
+
+  void load_slot(const instruction_s &ins) {
+    // A slot is only unbound before its local is first assigned, or
+    // after it is dropped, so the name is resolved as it normally is
+    if (auto &slot = env_.get_slot(ins.b)) {
+      registers_[ins.a] = slot;
+      return;
+    }
+    auto &symbol = chunk_.constants[ins.c];
+    auto loaded = current_env_->get(symbol->as_symbol_id());
+    if (!loaded) {
+      not_found(symbol);
+    }
+    registers_[ins.a] = loaded;
+  }
+
+  bool eval(const instruction_s &ins) {
+    registers_[ins.a] = ci_.process_statement(
+        chunk_.constants[ins.b], *current_env_, static_cast<bool>(ins.flag));
+    return completing();
+  }
+
+  bool call(const instruction_s &ins) {
+    auto &instruction = chunk_.constants[ins.b];
+    auto &head = instruction->as_list().front();
+
+    // The interpreter may have replaced the head with what it resolved
+    // to, and anything other than a plain function call is left to it
+    cell_ptr operation;
+    if (head->type == cell_type_e::SYMBOL) {
+      operation =
+          current_env_->get(head->as_symbol_id(), chunk_.caches[ins.c]);
+    }
+    if (ci_.is_terminating()) {
+      registers_[ins.a] = constant_nil();
+    } else if (ins.flag != static_cast<uint8_t>(call_e::NORMAL) &&
+               !ctx_depth_ &&
+               ci_.can_tail_call(instruction, operation, *current_env_)) {
+      ci_.tail_call(instruction, operation, *current_env_,
+                    ins.flag == static_cast<uint8_t>(call_e::TAIL_YIELD));
+    } else if (operation && operation->type == cell_type_e::FUNCTION) {
+      registers_[ins.a] = ci_.call(instruction, operation, *current_env_);
+    } else {
+      registers_[ins.a] =
+          ci_.process_statement(instruction, *current_env_, false);
+    }
+    return completing();
+  }
+
+  void assign(const instruction_s &ins) {
+    auto value = bind(registers_[ins.c]);
+    current_env_->set(chunk_.constants[ins.b]->as_symbol_id(), value);
+    registers_[ins.a] = value;
+  }
+
+  void assign_slot(const instruction_s &ins) {
+    auto value = bind(registers_[ins.c]);
+    if (auto &slot = env_.get_slot(ins.d)) {
+      slot = value;
+    } else {
+      current_env_->set(chunk_.constants[ins.b]->as_symbol_id(), value);
+    }
+    registers_[ins.a] = value;
+  }
+
+  void set(const instruction_s &ins) {
+    auto target = current_env_->writable(registers_[ins.b].box(),
+                                         chunk_.constants[ins.d]);
+    auto &source = registers_[ins.c];
+    if (source.cell) {
+      target->update_from(*source.cell, *current_env_);
+    } else {
+      target->update_from(source.type, source.data);
+    }
+    registers_[ins.a] = target;
+  }
+
+  //! \return True if the counter was stepped, and the jump is taken
+  bool step(const instruction_s &ins) {
+    auto &counter = registers_[ins.b];
+    if (!counter.cell || counter.cell->type != cell_type_e::I64 ||
+        counter.cell->is_constant()) {
+      return false;
+    }
+    kernels::apply<int64_t>(static_cast<arith_e>(ins.flag),
+                            counter.cell->data.i64,
+                            chunk_.constants[ins.c]->data.i64);
+    registers_[ins.d] = counter;
+    return true;
+  }
+
+  void arith(const instruction_s &ins) {
+    registers_[ins.a] = detail::arithmetic(
+        ci_, static_cast<arith_e>(ins.flag), chunk_.constants[ins.d],
+        &registers_[ins.b], ins.c, *current_env_);
+  }
+
+  void cmp(const instruction_s &ins) {
+    detail::value_s operands[2] = {registers_[ins.b], registers_[ins.c]};
+    registers_[ins.a] =
+        detail::comparison(ci_, static_cast<cmp_e>(ins.flag),
+                           chunk_.constants[ins.d], operands, *current_env_);
+  }
+
+  void negate(const instruction_s &ins) {
+    registers_[ins.a] =
+        detail::value_s::integer(!registers_[ins.b].to_integer());
+  }
+
+  //! \return True if the operand of a JUMP_UNLESS is truthy, so the
+  //!         jump is not taken
+  bool truthy(const instruction_s &ins) {
+    auto &value = registers_[ins.b];
+    if (ins.flag) {
+      return value.to_integer() > 0;
+    }
+    if (!value.cell && value.type == cell_type_e::I64) {
+      return value.data.i64 > 0;
+    }
+    return value.box()->as_integer() > 0;
+  }
+
+  bool terminating() const { return ci_.is_terminating(); }
+
+  void enter_env() {
+    scopes_[scope_depth_].emplace(current_env_);
+    current_env_ = &(*scopes_[scope_depth_]);
+    scope_depth_++;
+  }
+
+  void leave_env() {
+    scope_depth_--;
+    scopes_[scope_depth_].reset();
+    current_env_ = scope_depth_ ? &(*scopes_[scope_depth_ - 1]) : &env_;
+  }
+
+  void push_ctx() {
+    ci_.push_ctx();
+    ctx_depth_++;
+  }
+
+  void pop_ctx() {
+    ci_.pop_ctx(*current_env_);
+    ctx_depth_--;
+  }
+
+  //! \return The value the chunk yields
+  cell_ptr yield(const instruction_s &ins) {
+    auto value = ins.flag ? bind(registers_[ins.b]) : constant_integer(0);
+    ci_.yield(value);
+    close_contexts();
+    return value;
+  }
+
+  //! \return The value the chunk returns
+  cell_ptr ret(const instruction_s &ins) { return registers_[ins.a].box(); }
+
+  //! \return The value of a chunk that was left by completing
+  cell_ptr completion() { return ci_.get_completion_value(); }
+
+private:
+  interpreter_c &ci_;
+  chunk_c &chunk_;
+  env_c &env_;
+  std::vector<detail::value_s> registers_;
+  std::vector<std::optional<env_c>> scopes_;
+  std::size_t scope_depth_{0};
+  std::size_t ctx_depth_{0};
+  env_c *current_env_;
+  std::size_t call_depth_;
+
+  // Values that are bound are copies, unless they were never boxed
+  cell_ptr bind(detail::value_s &value) {
+    if (value.cell) {
+      return value.cell->clone(*current_env_);
+    }
+    return value.unshared();
+  }
+
+  // Close any contexts the chunk opened so they don't leak into the
+  // caller when it is left early by a yield
+  void close_contexts() {
+    while (ctx_depth_) {
+      ci_.pop_ctx(*current_env_);
+      ctx_depth_--;
+    }
+  }
+
+  bool completing() {
+    if (ci_.is_completing()) {
+      close_contexts();
+      return true;
+    }
+    return false;
+  }
+
+  [[noreturn]] void not_found(cell_ptr &symbol) {
+    throw interpreter_c::exception_c("Symbol not found in environment: " +
+                                         symbol->as_symbol(),
+                                     symbol->get_location());
+  }
+};
+
+} // namespace vm
+} // namespace nibi
@@ -0,0 +1,113 @@
+#include "vm.hpp"
+#include "machine.hpp"
+
+namespace nibi {
+namespace vm {
+
+cell_ptr execute(interpreter_c &ci, chunk_c &chunk, env_c &env) {
+  if (ci.is_completing()) {
+    return ci.get_completion_value();
+  }
+
+  machine_c machine(ci, chunk, env);
+  auto *code = chunk.code.data();
+  std::size_t pc{0};
+
+  // The calls to builtins that the machine makes itself are only
+  // traced once an error leaves the chunk, rather than as they are made
+  try {
+    while (true) {
+      auto &ins = code[pc++];
+      switch (ins.op) {
+      case op_e::NOP:
+        break;
+      case op_e::MOVE:
+        machine.move(ins);
+        break;
+      case op_e::LOAD_CONST:
+        machine.load_const(ins);
+        break;
+      case op_e::LOAD_NIL:
+        machine.load_nil(ins);
+        break;
+      case op_e::LOAD_LAST_RESULT:
+        machine.load_last_result(ins);
+        break;
+      case op_e::LOAD_SYM:
+        machine.load_sym(ins);
+        break;
+      case op_e::LOAD_SLOT:
+        machine.load_slot(ins);
+        break;
+      case op_e::EVAL:
+        if (machine.eval(ins)) {
+          return machine.completion();
+        }
+        break;
+      case op_e::CALL:
+        if (machine.call(ins)) {
+          return machine.completion();
+        }
+        break;
+      case op_e::ASSIGN:
+        machine.assign(ins);
+        break;
+      case op_e::ASSIGN_SLOT:
+        machine.assign_slot(ins);
+        break;
+      case op_e::SET:
+        machine.set(ins);
+        break;
+      case op_e::STEP:
+        if (machine.step(ins)) {
+          pc = ins.a;
+        }
+        break;
+      case op_e::ARITH:
+        machine.arith(ins);
+        break;
+      case op_e::CMP:
+        machine.cmp(ins);
+        break;
+      case op_e::NOT:
+        machine.negate(ins);
+        break;
+      case op_e::JUMP:
+        pc = ins.a;
+        break;
+      case op_e::JUMP_UNLESS:
+        if (!machine.truthy(ins)) {
+          pc = ins.a;
+        }
+        break;
+      case op_e::JUMP_IF_TERM:
+        if (machine.terminating()) {
+          pc = ins.a;
+        }
+        break;
+      case op_e::ENTER_ENV:
+        machine.enter_env();
+        break;
+      case op_e::LEAVE_ENV:
+        machine.leave_env();
+        break;
+      case op_e::PUSH_CTX:
+        machine.push_ctx();
+        break;
+      case op_e::POP_CTX:
+        machine.pop_ctx();
+        break;
+      case op_e::YIELD:
+        return machine.yield(ins);
+      case op_e::RETURN:
+        return machine.ret(ins);
+      }
+    }
+  } catch (...) {
+    machine.trace(pc - 1);
+    throw;
+  }
+}
+
+} // namespace vm
+} // namespace nibi
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "bytecode.hpp"
+
+namespace nibi {
+
+class interpreter_c;
+
+namespace vm {
+
+//! \brief Execute a chunk
+//! \param ci The interpreter that owns the execution
+//! \param chunk The chunk to execute
+//! \param env The environment to execute the chunk in
+//! \return The result of the chunk, or the yield value if
+//!         the chunk yielded
+extern cell_ptr execute(interpreter_c &ci, chunk_c &chunk, env_c &env);
+
+} // namespace vm
+} // namespace nibi
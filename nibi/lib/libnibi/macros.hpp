@@ -35,7 +35,7 @@ namespace nibi {
         std::string(___cmd) + " instruction expects " +                        \
             std::to_string(___size - 1) + " parameters, got " +                \
             std::to_string(list.size() - 1) + ".",                             \
-        list.front()->locator);                                                \
+        list.front()->get_location());                                         \
     return nibi::allocate_cell(nibi::cell_type_e::NIL);                        \
   }
 } // namespace nibi
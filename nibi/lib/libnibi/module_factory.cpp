@@ -22,6 +22,9 @@ public:
   virtual module_info_s get_module_info(std::string &name) override {
     return modules_.get_module_info(name);
   }
+  virtual std::filesystem::path compile_module(std::string &name) override {
+    return modules_.compile_module(name);
+  }
 
 private:
   env_c environment_;
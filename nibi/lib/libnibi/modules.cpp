@@ -1,11 +1,15 @@
 #include "modules.hpp"
 #include "libnibi/RLL/rll_wrapper.hpp"
+#include "libnibi/aot.hpp"
 #include "libnibi/config.hpp"
 #include "libnibi/front/file_interpreter.hpp"
 #include "libnibi/front/intake.hpp"
 #include "libnibi/interpreter/builtins/builtins.hpp"
 #include "libnibi/interpreter/interpreter.hpp"
+#include "libnibi/interpreter/vm/compiler.hpp"
 #include "libnibi/platform.hpp"
+#include "libnibi/version.hpp"
+#include <cstdlib>
 #include <fstream>
 #include <random>
 
@@ -80,7 +84,7 @@ std::filesystem::path modules_c::get_module_path(cell_ptr &module_name) {
 
   if (!opt_path.has_value()) {
     throw interpreter_c::exception_c("Could not locate module: " + name,
-                                     module_name->locator);
+                                     module_name->get_location());
   }
 
   // load the module
@@ -91,13 +95,13 @@ std::filesystem::path modules_c::get_module_path(cell_ptr &module_name) {
   if (!std::filesystem::exists(module_file)) {
     throw interpreter_c::exception_c("Could not locate module file: " +
                                          module_file.string(),
-                                     module_name->locator);
+                                     module_name->get_location());
   }
 
   if (!std::filesystem::is_regular_file(module_file)) {
     throw interpreter_c::exception_c("Module file is not a regular file: " +
                                          module_file.string(),
-                                     module_name->locator);
+                                     module_name->get_location());
   }
   return path;
 }
@@ -213,12 +217,14 @@ void modules_c::load_module(cell_ptr &module_name, env_c &target_env) {
   auto source_list = module_env.get("sources");
   if (source_list) {
     load_source_list(name, *module_cell_env.env, path, source_list);
+    load_compiled_bodies(name, *module_cell_env.env, path, source_list);
     loaded_something = true;
   }
 
   if (!loaded_something) {
     throw interpreter_c::exception_c(
-        "Module did not contain any loadable items", module_name->locator);
+        "Module did not contain any loadable items",
+        module_name->get_location());
   }
 
   auto new_env_cell = allocate_cell(module_cell_env);
@@ -241,7 +247,7 @@ modules_c::execute_post_import_actions(cell_ptr &post_list,
     if (!std::filesystem::exists(file)) {
       throw interpreter_c::exception_c("Could not locate post-import file: " +
                                            file.string(),
-                                       post_list->locator);
+                                       post_list->get_location());
     }
 
     populate_env(file, ci_, ci_.get_env());
@@ -260,13 +266,13 @@ inline cell_ptr modules_c::load_dylib(std::string &name, env_c &module_env,
   if (!std::filesystem::exists(lib_file)) {
     throw interpreter_c::exception_c("Could not locate dylib file: " +
                                          lib_file.string(),
-                                     dylib_list->locator);
+                                     dylib_list->get_location());
   }
 
   if (!std::filesystem::is_regular_file(lib_file)) {
     throw interpreter_c::exception_c("Dylib file is not a regular file: " +
                                          lib_file.string(),
-                                     dylib_list->locator);
+                                     dylib_list->get_location());
   }
 
   // Load the library with RLL
@@ -278,7 +284,7 @@ inline cell_ptr modules_c::load_dylib(std::string &name, env_c &module_env,
   } catch (rll_wrapper_c::library_loading_error_c &e) {
     throw interpreter_c::exception_c("Could not load library: " + name +
                                          ".\nFailed with error: " + e.what(),
-                                     dylib_list->locator);
+                                     dylib_list->get_location());
   }
 
   if (target_lib->has_symbol("nibi_runtime_init")) {
@@ -289,11 +295,11 @@ inline cell_ptr modules_c::load_dylib(std::string &name, env_c &module_env,
     } catch (const std::exception &e) {
       throw interpreter_c::exception_c("Module initialization failed: " + name +
                                            ".\nError: " + e.what(),
-                                       dylib_list->locator);
+                                       dylib_list->get_location());
     } catch (...) {
       throw interpreter_c::exception_c("Module initialization failed: " + name +
                                            ".\nUnknown error",
-                                       dylib_list->locator);
+                                       dylib_list->get_location());
     }
   }
 
@@ -310,7 +316,7 @@ inline cell_ptr modules_c::load_dylib(std::string &name, env_c &module_env,
     if (!target_lib->has_symbol(sym)) {
       std::string err =
           "Could not locate symbol: " + sym + " in library: " + name;
-      throw interpreter_c::exception_c(err, func->locator);
+      throw interpreter_c::exception_c(err, func->get_location());
     }
 
     auto target_cell = allocate_cell(function_info_s(
@@ -338,12 +344,29 @@ inline cell_ptr modules_c::load_dylib(std::string &name, env_c &module_env,
   return module_create_cell;
 }
 
+std::vector<std::filesystem::path>
+modules_c::get_source_files(std::string &name,
+                            std::filesystem::path &module_path,
+                            cell_ptr &source_list) {
+
+  std::vector<std::filesystem::path> result;
+  for (auto &source_file : source_list->as_list_info().list) {
+    auto source_file_path = module_path / source_file->as_string();
+    if (!std::filesystem::is_regular_file(source_file_path)) {
+      throw interpreter_c::exception_c(
+          "File listed in module: " + name +
+              " is not a regular file: " + source_file_path.string(),
+          source_file->get_location());
+    }
+    result.push_back(source_file_path);
+  }
+  return result;
+}
+
 inline void modules_c::load_source_list(std::string &name, env_c &module_env,
                                         std::filesystem::path &module_path,
                                         cell_ptr &source_list) {
 
-  auto source_list_info = source_list->as_list_info();
-
   error_callback_f error_callback = [&](error_c e) {
     e.draw();
     throw interpreter_c::exception_c("Error in module");
@@ -351,18 +374,136 @@ inline void modules_c::load_source_list(std::string &name, env_c &module_env,
 
   // Walk over each file given by the source list
   // and read it into the module env by way of the new interpreter
-  for (auto &source_file : source_list_info.list) {
-    auto source_file_path = module_path / source_file->as_string();
-    if (!std::filesystem::is_regular_file(source_file_path)) {
-      throw interpreter_c::exception_c(
-          "File listed in module: " + name +
-              " is not a regular file: " + source_file_path.string(),
-          source_file->locator);
-    }
-
+  for (auto &source_file_path :
+       get_source_files(name, module_path, source_list)) {
     file_interpreter_c(error_callback, module_env, source_manager_)
         .interpret_file(source_file_path);
   }
 }
 
+// A compiled module that can't be used is not an error, as the sources
+// it was compiled from were just loaded and can be executed as they are
+void modules_c::load_compiled_bodies(std::string &name, env_c &module_env,
+                                     std::filesystem::path &module_path,
+                                     cell_ptr &source_list) {
+
+  auto lib_file = module_path / (name + config::NIBI_AOT_LIBRARY_SUFFIX);
+  if (!std::filesystem::is_regular_file(lib_file)) {
+    return;
+  }
+
+  auto target_lib = allocate_rll();
+  try {
+    target_lib->load(lib_file.string());
+  } catch (rll_wrapper_c::library_loading_error_c &e) {
+    return;
+  }
+
+  if (!target_lib->has_symbol(aot::MANIFEST_SYMBOL)) {
+    return;
+  }
+
+  auto *manifest = reinterpret_cast<aot::manifest_f>(
+      target_lib->get_symbol(aot::MANIFEST_SYMBOL))();
+  if (manifest->abi != aot::ABI ||
+      std::string(manifest->version) != LIBNIBI_VERSION ||
+      manifest->sources_hash !=
+          aot::hash_files(get_source_files(name, module_path, source_list))) {
+    return;
+  }
+
+  // Each body is checked against the chunk it was compiled from, as
+  // the code refers to the constants of the chunk by index
+  std::size_t attached{0};
+  for (std::size_t i = 0; i < manifest->count; i++) {
+    auto &entry = manifest->entries[i];
+    auto id = symbols::find(entry.name);
+    auto cell = id ? module_env.get(*id) : nullptr;
+    if (!cell || cell->type != cell_type_e::FUNCTION) {
+      continue;
+    }
+
+    auto &info = cell->as_function_info();
+    if (info.type != function_type_e::LAMBDA_FUNCTION ||
+        !info.lambda.has_value()) {
+      continue;
+    }
+
+    auto chunk = vm::compiler_c::lower_lambda(*info.lambda);
+    if (!chunk || aot::fingerprint(*chunk) != entry.fingerprint) {
+      continue;
+    }
+    info.lambda->compiled = entry.body;
+    attached++;
+  }
+
+  if (!attached) {
+    return;
+  }
+  compiled_bodies_ += attached;
+
+  // Kept alive the same way as a dylib, see load_dylib
+  auto rll_cell = allocate_cell(
+      static_cast<aberrant_cell_if *>(new module_cell_c(target_lib)));
+  module_env.set(name + generate_random_id(), rll_cell);
+}
+
+std::filesystem::path modules_c::compile_module(std::string &name) {
+
+  cell_ptr mns = allocate_cell(name);
+
+  auto path = get_module_path(mns);
+
+  env_c module_env;
+  populate_env(path / config::NIBI_MODULE_FILE_NAME, ci_, module_env);
+
+  auto source_list = module_env.get("sources");
+  if (!source_list) {
+    throw interpreter_c::exception_c("Module does not list any sources: " +
+                                     name);
+  }
+
+  // The sources are loaded as they would be by load_module, so that
+  // the lambdas are lowered exactly as they will be when it is used
+  env_c sources_env;
+  load_source_list(name, sources_env, path, source_list);
+
+  std::vector<aot::body_s> bodies;
+  sources_env.for_each([&](symbol_id_t id, cell_ptr &cell) {
+    if (cell->type != cell_type_e::FUNCTION) {
+      return;
+    }
+    auto &info = cell->as_function_info();
+    if (info.type != function_type_e::LAMBDA_FUNCTION ||
+        !info.lambda.has_value()) {
+      return;
+    }
+    auto chunk = vm::compiler_c::lower_lambda(*info.lambda);
+    if (chunk && aot::can_translate(*chunk)) {
+      bodies.push_back({symbols::name_of(id), chunk});
+    }
+  });
+
+  auto sources_hash =
+      aot::hash_files(get_source_files(name, path, source_list));
+
+  auto source_file = path / (name + config::NIBI_AOT_SOURCE_SUFFIX);
+  {
+    std::ofstream out(source_file);
+    if (!out) {
+      throw interpreter_c::exception_c("Could not write file: " +
+                                       source_file.string());
+    }
+    out << aot::translate(name, sources_hash, bodies);
+  }
+
+  auto lib_file = path / (name + config::NIBI_AOT_LIBRARY_SUFFIX);
+  auto command = aot::build_command(source_file, lib_file);
+  if (std::system(command.c_str()) != 0) {
+    throw interpreter_c::exception_c("Could not compile module: " + name +
+                                     ".\nFailed command: " + command);
+  }
+  return lib_file;
+}
+
 } // namespace nibi
@@ -32,9 +32,24 @@ public:
   //! already been loaded
   void load_module(cell_ptr &module_name, env_c &target_env);
 
+  //! \brief Compile the lambdas defined by a module's sources ahead of
+  //!        time, see aot.hpp
+  //! \param module_name the name of the module
+  //! \return the library that was built, which is used by the lambdas
+  //!         whenever the module is loaded from the same sources
+  std::filesystem::path compile_module(std::string &module_name);
+
+  //! \brief Get the number of lambda bodies that were loaded compiled
+  std::size_t get_compiled_bodies() const { return compiled_bodies_; }
+
 private:
   std::filesystem::path get_module_path(cell_ptr &module_name);
 
+  std::vector<std::filesystem::path>
+  get_source_files(std::string &module_name,
+                   std::filesystem::path &module_path,
+                   cell_ptr &source_list_cell);
+
   cell_ptr load_dylib(std::string &module_name, env_c &module_env,
                       std::filesystem::path &module_path, cell_ptr &dylib_cell);
 
@@ -42,11 +57,16 @@ private:
                         std::filesystem::path &module_path,
                         cell_ptr &source_list_cell);
 
+  void load_compiled_bodies(std::string &module_name, env_c &module_env,
+                            std::filesystem::path &module_path,
+                            cell_ptr &source_list_cell);
+
   void execute_post_import_actions(cell_ptr &post_list,
                                    std::filesystem::path &module_path);
 
   source_manager_c &source_manager_;
   interpreter_c &ci_;
+  std::size_t compiled_bodies_{0};
 };
 
 } // namespace nibi
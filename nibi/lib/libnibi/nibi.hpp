@@ -9,5 +9,6 @@
 #include <libnibi/module_factory.hpp>
 #include <libnibi/platform.hpp>
 #include <libnibi/rang.hpp>
+#include <libnibi/runtime.hpp>
 #include <libnibi/source.hpp>
 #include <libnibi/version.hpp>
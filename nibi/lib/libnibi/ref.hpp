@@ -6,10 +6,13 @@
 namespace nibi {
 
 //! \brief Something that will be reference counted
+//! \note  The destructor is not virtual so that counted objects
+//!        carry no vtable. Types that are deleted through a base
+//!        pointer must declare a virtual destructor themselves.
 class ref_counted_c {
 public:
   ref_counted_c() {}
-  virtual ~ref_counted_c() {}
+  ~ref_counted_c() {}
 
   const ref_counted_c *acquire() const {
     ref_count_++;
@@ -18,7 +21,18 @@ public:
   int64_t release() const { return --ref_count_; }
   int64_t refCount() const { return ref_count_; }
 
+  //! \brief Exempt the object from ever being freed by its references
+  //! \note  The count is set so high that it can not be released to zero
+  void make_immortal() const { ref_count_ = IMMORTAL_REF_COUNT; }
+
+  //! \brief Check if the object was made immortal
+  bool is_immortal() const { return ref_count_ >= IMMORTAL_REF_COUNT / 2; }
+
 private:
+  static constexpr config::ref_counter_underlying_type_t IMMORTAL_REF_COUNT =
+      config::ref_counter_underlying_type_t(1)
+      << (sizeof(config::ref_counter_underlying_type_t) * 8 - 1);
+
   ref_counted_c(const ref_counted_c &);
   ref_counted_c &operator=(const ref_counted_c &);
 
@@ -37,11 +51,32 @@ public:
     acquire(rhs.object_);
   }
 
+  //! \brief Take over the reference held by another pointer, which is
+  //!        left null, without touching the count
+  ref_counted_ptr_c(ref_counted_ptr_c &&rhs) : object_(rhs.object_) {
+    rhs.object_ = nullptr;
+  }
+
   const ref_counted_ptr_c &operator=(const ref_counted_ptr_c &rhs) {
     acquire(rhs.object_);
     return *this;
   }
 
+  const ref_counted_ptr_c &operator=(ref_counted_ptr_c &&rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    // The object held may be what keeps rhs alive, so it is only
+    // released once rhs has been taken from
+    T *previous = object_;
+    object_ = rhs.object_;
+    rhs.object_ = nullptr;
+    if (previous != nullptr && previous->release() == 0) {
+      delete previous;
+    }
+    return *this;
+  }
+
   T &operator*() const { return *object_; }
 
   T *get() const { return object_; }
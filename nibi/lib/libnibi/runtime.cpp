@@ -0,0 +1,7 @@
+#include "runtime.hpp"
+
+namespace nibi {
+
+runtime_options_s global_runtime_options;
+
+} // namespace nibi
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace nibi {
+
+//! \brief Process wide options that alter how code is executed
+//!        but never what it computes
+struct runtime_options_s {
+  bool bytecode{true}; // Lower hot instructions to bytecode before executing
+  bool jit{true};      // Compile hot lambda bytecode to native code
+};
+
+extern runtime_options_s global_runtime_options;
+
+} // namespace nibi
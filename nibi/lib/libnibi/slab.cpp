@@ -0,0 +1,217 @@
+#include "libnibi/slab.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace nibi {
+namespace slab {
+
+#if NIBI_SLAB_ALLOCATOR
+
+namespace {
+
+// Sizes are rounded up to a granule, which also keeps every
+// block aligned for anything a cell or its structures hold
+static constexpr std::size_t GRANULE = 16;
+static constexpr std::size_t MAX_BLOCK_SIZE = 512;
+static constexpr std::size_t NUM_SIZE_CLASSES = MAX_BLOCK_SIZE / GRANULE;
+static constexpr std::size_t SLAB_SIZE = 64 * 1024;
+
+struct free_block_s {
+  free_block_s *next;
+};
+
+// Slabs are aligned to their size so that the header at the front
+// of one can be found from any block within it. The header takes
+// up the first block, which is never handed out.
+struct slab_header_s {
+  std::atomic<uint64_t *> side_words;
+};
+
+static_assert(sizeof(slab_header_s) <= GRANULE);
+
+// Kept trivial so that reaching it from the hot path is only a
+// thread local access, with no guard for construction
+struct thread_cache_s {
+  free_block_s *free_lists[NUM_SIZE_CLASSES];
+};
+
+thread_local thread_cache_s thread_cache;
+
+// Free lists of threads that have exited, which are handed
+// out again to whichever thread next runs dry
+std::mutex orphans_lock;
+free_block_s *orphans[NUM_SIZE_CLASSES];
+
+struct thread_exit_s {
+  ~thread_exit_s() {
+    std::lock_guard<std::mutex> lock(orphans_lock);
+    for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+      auto *head = thread_cache.free_lists[i];
+      if (!head) {
+        continue;
+      }
+      auto *tail = head;
+      while (tail->next) {
+        tail = tail->next;
+      }
+      tail->next = orphans[i];
+      orphans[i] = head;
+      thread_cache.free_lists[i] = nullptr;
+    }
+  }
+};
+
+inline std::size_t size_class(std::size_t size) {
+  return (size + GRANULE - 1) / GRANULE - 1;
+}
+
+inline std::size_t block_size_of(std::size_t size) {
+  return (size_class(size) + 1) * GRANULE;
+}
+
+// Slabs are never returned, the blocks carved from them
+// are recycled for the life of the process
+free_block_s *refill(std::size_t index) {
+  thread_local thread_exit_s on_exit;
+  (void)on_exit;
+
+  {
+    std::lock_guard<std::mutex> lock(orphans_lock);
+    if (auto *adopted = orphans[index]) {
+      orphans[index] = nullptr;
+      return adopted;
+    }
+  }
+
+  auto block_size = (index + 1) * GRANULE;
+  auto count = SLAB_SIZE / block_size;
+  auto *slab = static_cast<char *>(
+      ::operator new(SLAB_SIZE, std::align_val_t(SLAB_SIZE)));
+  new (slab) slab_header_s{nullptr};
+
+  free_block_s *head{nullptr};
+  for (std::size_t i = count; i > 1; i--) {
+    auto *block =
+        reinterpret_cast<free_block_s *>(slab + (i - 1) * block_size);
+    block->next = head;
+    head = block;
+  }
+  return head;
+}
+
+inline slab_header_s *header_of(const void *ptr) {
+  return reinterpret_cast<slab_header_s *>(reinterpret_cast<uintptr_t>(ptr) &
+                                           ~(SLAB_SIZE - 1));
+}
+
+inline std::size_t index_in_slab(const void *ptr, std::size_t size) {
+  return (reinterpret_cast<uintptr_t>(ptr) & (SLAB_SIZE - 1)) /
+         block_size_of(size);
+}
+
+// Blocks too large for a slab keep their side words here
+std::mutex large_side_words_lock;
+std::unordered_map<const void *, uint64_t> large_side_words;
+
+} // namespace
+
+void *allocate(std::size_t size) {
+  if (size > MAX_BLOCK_SIZE) {
+    return ::operator new(size);
+  }
+  auto index = size_class(size);
+  auto *block = thread_cache.free_lists[index];
+  if (!block) {
+    block = refill(index);
+  }
+  thread_cache.free_lists[index] = block->next;
+  return block;
+}
+
+void deallocate(void *ptr, std::size_t size) {
+  if (!ptr) {
+    return;
+  }
+  if (size > MAX_BLOCK_SIZE) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto index = size_class(size);
+  auto *block = static_cast<free_block_s *>(ptr);
+  block->next = thread_cache.free_lists[index];
+  thread_cache.free_lists[index] = block;
+}
+
+uint64_t get_side_word(const void *ptr, std::size_t size) {
+  if (size > MAX_BLOCK_SIZE) {
+    std::lock_guard<std::mutex> lock(large_side_words_lock);
+    auto it = large_side_words.find(ptr);
+    return it == large_side_words.end() ? 0 : it->second;
+  }
+  auto *words = header_of(ptr)->side_words.load(std::memory_order_acquire);
+  return words ? words[index_in_slab(ptr, size)] : 0;
+}
+
+void set_side_word(const void *ptr, std::size_t size, uint64_t word) {
+  if (size > MAX_BLOCK_SIZE) {
+    std::lock_guard<std::mutex> lock(large_side_words_lock);
+    if (word) {
+      large_side_words[ptr] = word;
+    } else {
+      large_side_words.erase(ptr);
+    }
+    return;
+  }
+  auto &side_words = header_of(ptr)->side_words;
+  auto *words = side_words.load(std::memory_order_acquire);
+  if (!words) {
+    if (!word) {
+      return;
+    }
+
+    // Blocks of one slab may be in use by several threads,
+    // so only the first to install storage for it wins
+    auto *created = new uint64_t[SLAB_SIZE / block_size_of(size)]();
+    if (side_words.compare_exchange_strong(words, created,
+                                           std::memory_order_acq_rel)) {
+      words = created;
+    } else {
+      delete[] created;
+    }
+  }
+  words[index_in_slab(ptr, size)] = word;
+}
+
+#else
+
+void *allocate(std::size_t size) { return ::operator new(size); }
+
+void deallocate(void *ptr, std::size_t) { ::operator delete(ptr); }
+
+namespace {
+std::mutex side_words_lock;
+std::unordered_map<const void *, uint64_t> side_words;
+} // namespace
+
+uint64_t get_side_word(const void *ptr, std::size_t) {
+  std::lock_guard<std::mutex> lock(side_words_lock);
+  auto it = side_words.find(ptr);
+  return it == side_words.end() ? 0 : it->second;
+}
+
+void set_side_word(const void *ptr, std::size_t, uint64_t word) {
+  std::lock_guard<std::mutex> lock(side_words_lock);
+  if (word) {
+    side_words[ptr] = word;
+  } else {
+    side_words.erase(ptr);
+  }
+}
+
+#endif
+
+} // namespace slab
+} // namespace nibi
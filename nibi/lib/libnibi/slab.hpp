@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nibi {
+
+//! \brief Size class allocator for cells and the structures they own.
+//!        Objects are carved out of large slabs and recycled through
+//!        thread local free lists, so the churn of short lived cells
+//!        stays within a few pages rather than going through malloc
+//! \note  Building with WITH_SLAB_ALLOCATOR=OFF routes everything
+//!        through the global operator new, for comparison and for use
+//!        with leak checkers as slabs are held until the process exits
+namespace slab {
+
+//! \brief Allocate memory for an object
+//! \param size The size of the object
+//! \return Memory suitably aligned for the object
+extern void *allocate(std::size_t size);
+
+//! \brief Deallocate memory given by allocate
+//! \param ptr The memory to deallocate
+//! \param size The size that was given to allocate
+//! \note  Memory may be deallocated by a thread other than
+//!        the one that allocated it
+extern void deallocate(void *ptr, std::size_t size);
+
+//! \brief Get the side word of a block
+//! \param ptr A block given by allocate
+//! \param size The size that was given to allocate
+//! \return The word last stored for the block, or 0 if none was
+//! \note  Side words hold data that only a few blocks need, without
+//!        every block growing to make room for it. Storage for them
+//!        is only created once a slab first has a word stored.
+extern uint64_t get_side_word(const void *ptr, std::size_t size);
+
+//! \brief Store the side word of a block
+//! \param ptr A block given by allocate
+//! \param size The size that was given to allocate
+//! \param word The word to store
+//! \note  Side words are not reset by deallocate, so a block that had a
+//!        word stored must be reset to 0 before it is deallocated
+extern void set_side_word(const void *ptr, std::size_t size, uint64_t word);
+
+} // namespace slab
+} // namespace nibi
+
+//! \brief Route heap allocations of the type it is placed
+//!        in through the slab allocator
+#define NIBI_SLAB_ALLOCATED                                                    \
+  static void *operator new(std::size_t size) {                                \
+    return nibi::slab::allocate(size);                                         \
+  }                                                                            \
+  static void operator delete(void *ptr, std::size_t size) {                   \
+    nibi::slab::deallocate(ptr, size);                                         \
+  }
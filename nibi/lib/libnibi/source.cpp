@@ -1,12 +1,67 @@
 #include "libnibi/source.hpp"
 #include "libnibi/rang.hpp"
 
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 namespace nibi {
+namespace sources {
+
+namespace {
+
+class table_c {
+public:
+  table_c() { intern(""); }
+
+  source_id_t intern(const std::string &name) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    if (names_.size() > std::numeric_limits<source_id_t>::max()) {
+      throw std::runtime_error("Too many sources to locate: " + name);
+    }
+
+    // Names live in a deque so that those handed
+    // out by reference are never moved
+    auto id = static_cast<source_id_t>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+  }
+
+  const std::string &name_of(source_id_t id) {
+    std::lock_guard<std::mutex> lock(lock_);
+    return names_[id];
+  }
+
+private:
+  std::mutex lock_;
+  std::unordered_map<std::string, source_id_t> ids_;
+  std::deque<std::string> names_;
+};
+
+table_c &table() {
+  static table_c instance;
+  return instance;
+}
+
+} // namespace
+
+source_id_t intern(const std::string &name) { return table().intern(name); }
+
+const std::string &name_of(source_id_t id) { return table().name_of(id); }
+
+} // namespace sources
+
 void draw_locator(locator_if &location) {
 
   std::cout << rang::fg::magenta << location.get_source_name()
@@ -34,18 +89,16 @@ void draw_locator(locator_if &location) {
   uint64_t line_number{0};
 
   // Determine the upper and lower bound for a source code window
-  int64_t upper_bound = location.get_line() + 4;
-  int64_t lower_bound = (int64_t)location.get_line() - 5;
-  if (lower_bound < 0) {
-    lower_bound = 0;
-  }
+  auto location_line = static_cast<uint64_t>(location.get_line());
+  uint64_t upper_bound = location_line + 4;
+  uint64_t lower_bound = location_line > 5 ? location_line - 5 : 0;
 
   // Build a window of source code to display
   while (std::getline(fs, line_data)) {
     line_number++;
-    if ((line_number >= lower_bound && lower_bound < location.get_line()) ||
-        location.get_line() == line_number ||
-        line_number > location.get_line() && line_number < upper_bound) {
+    if ((line_number >= lower_bound && lower_bound < location_line) ||
+        location_line == line_number ||
+        (line_number > location_line && line_number < upper_bound)) {
       window.push_back({.number = line_number, .data = line_data});
     }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -18,7 +20,6 @@ public:
   virtual const size_t get_column() const = 0;
   virtual const char *get_source_name() const = 0;
   virtual std::tuple<size_t, size_t> get_line_column() const = 0;
-  virtual nibi::ref_counted_ptr_c<locator_if> clone() = 0;
 };
 
 // Shorthand for a shared locator interface pointer.
@@ -33,25 +34,97 @@ public:
   //! \param source The name of the source.
   //! \param line The line of the source.
   //! \param column The column of the source.
-  locator_c(std::shared_ptr<std::string> source, const size_t line,
-            const size_t column)
-      : line_(line), column_(column), source_name_(source) {}
+  locator_c(std::string source, const size_t line, const size_t column)
+      : line_(line), column_(column), source_name_(std::move(source)) {}
   virtual std::tuple<size_t, size_t> get_line_column() const override {
     return std::make_tuple(line_, column_);
   }
   virtual const size_t get_line() const override { return line_; }
   virtual const size_t get_column() const override { return column_; }
   virtual const char *get_source_name() const override {
-    return source_name_->c_str();
+    return source_name_.c_str();
   }
-  virtual locator_ptr clone() override {
-    return new locator_c(source_name_, line_, column_);
+
+private:
+  const size_t line_{0};
+  const size_t column_{0};
+  std::string source_name_;
+};
+
+//! \brief Dense identifier of a registered source
+using source_id_t = uint16_t;
+
+namespace sources {
+
+//! \brief The id of locations that do not refer to any source
+static constexpr source_id_t NONE = 0;
+
+//! \brief Register a source name, allocating an id for it if
+//!        it has not been seen before
+//! \param name The name of the source
+//! \return The id of the source
+//! \throws std::runtime_error if every id has been handed out
+extern source_id_t intern(const std::string &name);
+
+//! \brief Retrieve the name of a registered source
+//! \param id The id of the source
+//! \return The name of the source
+//! \note  The reference remains valid for the life of the process
+extern const std::string &name_of(source_id_t id);
+
+} // namespace sources
+
+//! \brief A location within a source, packed into a single word so that
+//!        tokens and cells carry it inline rather than each owning a
+//!        heap allocated locator. A locator is only materialized from it
+//!        when an error is to be drawn.
+//! \note  Lines and columns too large to be packed are saturated
+struct location_s {
+  constexpr location_s() = default;
+
+  //! \brief Create a location
+  //! \param source The id of the source
+  //! \param line The line within the source
+  //! \param column The column within the line
+  location_s(source_id_t source, size_t line, size_t column)
+      : packed_(static_cast<uint64_t>(source) << SOURCE_SHIFT |
+                static_cast<uint64_t>(std::min(line, MAX_LINE)) << LINE_SHIFT |
+                std::min(column, MAX_COLUMN)) {}
+
+  //! \brief Check if the location refers to a source
+  explicit operator bool() const { return get_source_id() != sources::NONE; }
+
+  source_id_t get_source_id() const { return packed_ >> SOURCE_SHIFT; }
+  size_t get_line() const { return (packed_ >> LINE_SHIFT) & MAX_LINE; }
+  size_t get_column() const { return packed_ & MAX_COLUMN; }
+  const char *get_source_name() const {
+    return sources::name_of(get_source_id()).c_str();
+  }
+
+  //! \brief Get the single word the location is packed into
+  uint64_t get_packed() const { return packed_; }
+
+  //! \brief Recreate a location from the word given by get_packed
+  static location_s from_packed(uint64_t packed) {
+    location_s location;
+    location.packed_ = packed;
+    return location;
+  }
+
+  //! \brief Create a locator interface for the location
+  locator_ptr materialize() const {
+    return new locator_c(get_source_name(), get_line(), get_column());
   }
 
 private:
-  const config::locator_line_underlying_type_t line_{0};
-  const config::locator_column_underlying_type_t column_{0};
-  std::shared_ptr<std::string> source_name_{nullptr};
+  static constexpr uint64_t LINE_SHIFT = config::LOCATION_COLUMN_BITS;
+  static constexpr uint64_t SOURCE_SHIFT =
+      LINE_SHIFT + config::LOCATION_LINE_BITS;
+  static constexpr size_t MAX_LINE = (1ull << config::LOCATION_LINE_BITS) - 1;
+  static constexpr size_t MAX_COLUMN =
+      (1ull << config::LOCATION_COLUMN_BITS) - 1;
+
+  uint64_t packed_{0};
 };
 
 //! \brief A source origin. (File, string, etc.)
@@ -65,17 +138,17 @@ public:
   //! \brief Create a source origin.
   //! \param source_name The name of the source.
   source_origin_c(std::string source_name)
-      : source_name_(std::make_shared<std::string>(source_name)) {}
+      : id_(sources::intern(source_name)) {}
 
   //! \brief Get the name of the source.
-  std::string get_source_name() { return *source_name_; }
-  //! \brief Get a locator interface for the source.
-  locator_ptr get_locator(const size_t line, const size_t column) const {
-    return new locator_c(source_name_, line, column);
+  std::string get_source_name() { return sources::name_of(id_); }
+  //! \brief Get a location within the source.
+  location_s get_location(const size_t line, const size_t column) const {
+    return location_s(id_, line, column);
   }
 
 private:
-  std::shared_ptr<std::string> source_name_{nullptr};
+  source_id_t id_{sources::NONE};
 };
 
 //! \brief A source manager that manages all the sources.
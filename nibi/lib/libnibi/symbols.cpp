@@ -0,0 +1,69 @@
+#include "symbols.hpp"
+
+#include <deque>
+#include <unordered_map>
+
+namespace nibi {
+namespace symbols {
+
+namespace {
+
+struct entry_s {
+  std::string name;
+  bool is_private{false};
+};
+
+class table_c {
+public:
+  table_c() { intern(""); }
+
+  symbol_id_t intern(const std::string &name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+
+    // Entries live in a deque so that the names handed
+    // out by reference are never moved
+    auto id = static_cast<symbol_id_t>(entries_.size());
+    entries_.push_back(entry_s{name, name.starts_with("_")});
+    ids_.emplace(name, id);
+    return id;
+  }
+
+  std::optional<symbol_id_t> find(const std::string &name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  const entry_s &entry(symbol_id_t id) const { return entries_[id]; }
+
+private:
+  std::unordered_map<std::string, symbol_id_t> ids_;
+  std::deque<entry_s> entries_;
+};
+
+// Constructed on first use so that symbols can be
+// interned during static initialization
+table_c &table() {
+  static table_c instance;
+  return instance;
+}
+
+} // namespace
+
+symbol_id_t intern(const std::string &name) { return table().intern(name); }
+
+std::optional<symbol_id_t> find(const std::string &name) {
+  return table().find(name);
+}
+
+const std::string &name_of(symbol_id_t id) { return table().entry(id).name; }
+
+bool is_private(symbol_id_t id) { return table().entry(id).is_private; }
+
+} // namespace symbols
+} // namespace nibi
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace nibi {
+
+//! \brief Dense identifier of an interned symbol
+using symbol_id_t = uint32_t;
+
+namespace symbols {
+
+//! \brief The id of the empty symbol, interned before any other
+static constexpr symbol_id_t EMPTY = 0;
+
+//! \brief Intern a symbol name, allocating an id for it if
+//!        it has not been seen before
+//! \param name The name to intern
+//! \return The id of the name
+extern symbol_id_t intern(const std::string &name);
+
+//! \brief Find the id of a name without interning it
+//! \param name The name to find
+//! \return The id iff the name has been interned
+extern std::optional<symbol_id_t> find(const std::string &name);
+
+//! \brief Retrieve the name of an interned symbol
+//! \param id The id of the symbol
+//! \return The name of the symbol
+//! \note  The reference remains valid for the life of the process
+extern const std::string &name_of(symbol_id_t id);
+
+//! \brief Check if a symbol is considered private (leading `_`)
+//! \param id The id of the symbol
+extern bool is_private(symbol_id_t id);
+
+} // namespace symbols
+} // namespace nibi
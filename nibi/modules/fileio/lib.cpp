@@ -19,14 +19,15 @@ nibi::cell_ptr nibi_fopen(nibi::interpreter_c &ci, nibi::cell_list_t &list,
 
   if (arg1->type != nibi::cell_type_e::STRING) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `string`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg2->type != nibi::cell_type_e::STRING) {
     throw nibi::interpreter_c::exception_c("arg2 must be of type `string`",
-                                           list[2]->locator);
+                                           list[2]->get_location());
   }
   if (!valid_modes.contains(arg2->as_string())) {
-    throw nibi::interpreter_c::exception_c("Invalid mode", list[2]->locator);
+    throw nibi::interpreter_c::exception_c("Invalid mode",
+                                           list[2]->get_location());
   }
 
   auto result = nibi::allocate_cell(nibi::cell_type_e::PTR);
@@ -40,7 +41,7 @@ nibi::cell_ptr nibi_fclose(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -59,11 +60,11 @@ nibi::cell_ptr nibi_fputs(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg2 = ci.process_cell(list[2], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg2->type != nibi::cell_type_e::STRING) {
     throw nibi::interpreter_c::exception_c("arg2 must be of type `string`",
-                                           list[2]->locator);
+                                           list[2]->get_location());
   }
   return nibi::allocate_cell(
       (int64_t)(fputs(arg2->data.cstr, (FILE *)arg1->data.ptr)));
@@ -77,15 +78,15 @@ nibi::cell_ptr nibi_fprintf(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg3 = ci.process_cell(list[3], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg2->type != nibi::cell_type_e::STRING) {
     throw nibi::interpreter_c::exception_c("arg2 must be of type `string`",
-                                           list[2]->locator);
+                                           list[2]->get_location());
   }
   if (arg3->type != nibi::cell_type_e::STRING) {
     throw nibi::interpreter_c::exception_c("arg23must be of type `string`",
-                                           list[3]->locator);
+                                           list[3]->get_location());
   }
   return nibi::allocate_cell((int64_t)(fprintf(
       (FILE *)arg1->data.ptr, arg2->data.cstr, arg3->data.cstr)));
@@ -100,19 +101,19 @@ nibi::cell_ptr nibi_fwrite(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg4 = ci.process_cell(list[4], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg2->type != nibi::cell_type_e::I64) {
     throw nibi::interpreter_c::exception_c("arg2 must be of type `i64`",
-                                           list[2]->locator);
+                                           list[2]->get_location());
   }
   if (arg3->type != nibi::cell_type_e::I64) {
     throw nibi::interpreter_c::exception_c("arg3 must be of type `i64`",
-                                           list[3]->locator);
+                                           list[3]->get_location());
   }
   if (arg4->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg4 must be of type `ptr`",
-                                           list[4]->locator);
+                                           list[4]->get_location());
   }
 
   return nibi::allocate_cell(
@@ -127,11 +128,11 @@ nibi::cell_ptr nibi_fgets(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg2 = ci.process_cell(list[2], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg2->type != nibi::cell_type_e::I64) {
     throw nibi::interpreter_c::exception_c("arg2 must be of type `i64`",
-                                           list[2]->locator);
+                                           list[2]->get_location());
   }
   auto result_cell = nibi::allocate_cell(nibi::cell_type_e::NIL);
   result_cell->type = nibi::cell_type_e::STRING;
@@ -150,7 +151,7 @@ nibi::cell_ptr nibi_fgetc(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -172,7 +173,7 @@ nibi::cell_ptr nibi_feof(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -186,7 +187,7 @@ nibi::cell_ptr nibi_ftell(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -200,7 +201,7 @@ nibi::cell_ptr nibi_rewind(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -215,7 +216,7 @@ nibi::cell_ptr nibi_clearerr(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -230,7 +231,7 @@ nibi::cell_ptr nibi_ferror(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg1 = ci.process_cell(list[1], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg1->data.ptr == nullptr) {
     return nibi::allocate_cell((int64_t)-1);
@@ -246,15 +247,15 @@ nibi::cell_ptr nibi_fseek(nibi::interpreter_c &ci, nibi::cell_list_t &list,
   auto arg3 = ci.process_cell(list[3], env);
   if (arg1->type != nibi::cell_type_e::PTR) {
     throw nibi::interpreter_c::exception_c("arg1 must be of type `ptr`",
-                                           list[1]->locator);
+                                           list[1]->get_location());
   }
   if (arg2->type != nibi::cell_type_e::I64) {
     throw nibi::interpreter_c::exception_c("arg2 must be of type `i64`",
-                                           list[2]->locator);
+                                           list[2]->get_location());
   }
   if (arg3->type != nibi::cell_type_e::I64) {
     throw nibi::interpreter_c::exception_c("arg3 must be of type `i64`",
-                                           list[3]->locator);
+                                           list[3]->get_location());
   }
   return nibi::allocate_cell(
       (int64_t)(fseek((FILE *)arg1->data.ptr, arg2->data.i64, arg3->data.i64)));
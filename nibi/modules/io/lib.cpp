@@ -31,7 +31,7 @@ nibi::cell_ptr nibi_get_int(nibi::interpreter_c &ci, nibi::cell_list_t &list,
     return nibi::allocate_cell(nibi::cell_type_e::NIL);
   }
   auto r = nibi::allocate_cell((int64_t)val);
-  r->locator = list[0]->locator;
+  r->set_location(list[0]->get_location());
   return r;
 }
 
@@ -49,7 +49,7 @@ nibi::cell_ptr nibi_get_double(nibi::interpreter_c &ci, nibi::cell_list_t &list,
     return nibi::allocate_cell(nibi::cell_type_e::NIL);
   }
   auto r = nibi::allocate_cell((double)val);
-  r->locator = list[0]->locator;
+  r->set_location(list[0]->get_location());
   return r;
 }
 
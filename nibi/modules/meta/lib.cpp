@@ -10,5 +10,92 @@ nibi::cell_ptr meta_cell(nibi::interpreter_c &ci, nibi::cell_list_t &list,
 
 nibi::cell_ptr meta_locator(nibi::interpreter_c &ci, nibi::cell_list_t &list,
                             nibi::env_c &env) {
-  return nibi::allocate_cell((int64_t)sizeof(nibi::locator_ptr));
+  return nibi::allocate_cell((int64_t)sizeof(nibi::location_s));
+}
+
+nibi::cell_ptr meta_eval_cache_hits(nibi::interpreter_c &ci,
+                                    nibi::cell_list_t &list,
+                                    nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)ci.get_eval_cache().get_stats().hits);
+}
+
+nibi::cell_ptr meta_eval_cache_misses(nibi::interpreter_c &ci,
+                                      nibi::cell_list_t &list,
+                                      nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)ci.get_eval_cache().get_stats().misses);
+}
+
+nibi::cell_ptr meta_eval_cache_evictions(nibi::interpreter_c &ci,
+                                         nibi::cell_list_t &list,
+                                         nibi::env_c &env) {
+  return nibi::allocate_cell(
+      (int64_t)ci.get_eval_cache().get_stats().evictions);
+}
+
+nibi::cell_ptr meta_binding_cache_hits(nibi::interpreter_c &ci,
+                                       nibi::cell_list_t &list,
+                                       nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)nibi::env_c::get_cache_stats().hits);
+}
+
+nibi::cell_ptr meta_binding_cache_misses(nibi::interpreter_c &ci,
+                                         nibi::cell_list_t &list,
+                                         nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)nibi::env_c::get_cache_stats().misses);
+}
+
+nibi::cell_ptr meta_jit_compiled(nibi::interpreter_c &ci,
+                                 nibi::cell_list_t &list, nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)ci.get_jit_stats().compiled);
+}
+
+nibi::cell_ptr meta_jit_deoptimized(nibi::interpreter_c &ci,
+                                    nibi::cell_list_t &list,
+                                    nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)ci.get_jit_stats().deoptimized);
+}
+
+nibi::cell_ptr meta_jit_bailouts(nibi::interpreter_c &ci,
+                                 nibi::cell_list_t &list, nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)ci.get_jit_stats().bailouts);
+}
+
+nibi::cell_ptr meta_aot_bodies(nibi::interpreter_c &ci,
+                               nibi::cell_list_t &list, nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)ci.get_aot_bodies());
+}
+
+nibi::cell_ptr meta_collections(nibi::interpreter_c &ci,
+                                nibi::cell_list_t &list, nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)nibi::collector::get_stats().collections);
+}
+
+nibi::cell_ptr meta_collected(nibi::interpreter_c &ci, nibi::cell_list_t &list,
+                              nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)nibi::collector::get_stats().collected);
+}
+
+nibi::cell_ptr meta_collected_bytes(nibi::interpreter_c &ci,
+                                    nibi::cell_list_t &list,
+                                    nibi::env_c &env) {
+  return nibi::allocate_cell(
+      (int64_t)nibi::collector::get_stats().collected_bytes);
+}
+
+nibi::cell_ptr meta_collector_pause_us(nibi::interpreter_c &ci,
+                                       nibi::cell_list_t &list,
+                                       nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)nibi::collector::get_stats().pause_us);
+}
+
+nibi::cell_ptr meta_collector_max_pause_us(nibi::interpreter_c &ci,
+                                           nibi::cell_list_t &list,
+                                           nibi::env_c &env) {
+  return nibi::allocate_cell(
+      (int64_t)nibi::collector::get_stats().max_pause_us);
+}
+
+nibi::cell_ptr meta_collect(nibi::interpreter_c &ci, nibi::cell_list_t &list,
+                            nibi::env_c &env) {
+  return nibi::allocate_cell((int64_t)nibi::collector::collect());
 }
@@ -25,6 +25,66 @@ extern nibi::cell_ptr meta_cell(nibi::interpreter_c &ci,
 API_EXPORT
 extern nibi::cell_ptr meta_locator(nibi::interpreter_c &ci,
                                    nibi::cell_list_t &list, nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_eval_cache_hits(nibi::interpreter_c &ci,
+                                           nibi::cell_list_t &list,
+                                           nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_eval_cache_misses(nibi::interpreter_c &ci,
+                                             nibi::cell_list_t &list,
+                                             nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_eval_cache_evictions(nibi::interpreter_c &ci,
+                                                nibi::cell_list_t &list,
+                                                nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_binding_cache_hits(nibi::interpreter_c &ci,
+                                              nibi::cell_list_t &list,
+                                              nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_binding_cache_misses(nibi::interpreter_c &ci,
+                                                nibi::cell_list_t &list,
+                                                nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_jit_compiled(nibi::interpreter_c &ci,
+                                        nibi::cell_list_t &list,
+                                        nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_jit_deoptimized(nibi::interpreter_c &ci,
+                                           nibi::cell_list_t &list,
+                                           nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_jit_bailouts(nibi::interpreter_c &ci,
+                                        nibi::cell_list_t &list,
+                                        nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_aot_bodies(nibi::interpreter_c &ci,
+                                      nibi::cell_list_t &list,
+                                      nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_collections(nibi::interpreter_c &ci,
+                                       nibi::cell_list_t &list,
+                                       nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_collected(nibi::interpreter_c &ci,
+                                     nibi::cell_list_t &list,
+                                     nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_collected_bytes(nibi::interpreter_c &ci,
+                                           nibi::cell_list_t &list,
+                                           nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_collector_pause_us(nibi::interpreter_c &ci,
+                                              nibi::cell_list_t &list,
+                                              nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_collector_max_pause_us(nibi::interpreter_c &ci,
+                                                  nibi::cell_list_t &list,
+                                                  nibi::env_c &env);
+API_EXPORT
+extern nibi::cell_ptr meta_collect(nibi::interpreter_c &ci,
+                                   nibi::cell_list_t &list,
+                                   nibi::env_c &env);
 }
 
 #ifdef __clang__